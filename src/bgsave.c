@@ -0,0 +1,77 @@
+#include "include/bgsave.h"
+#include "include/error.h"
+#include <errno.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Código del proceso hijo: escribe en un archivo temporal y lo renombra al
+// final, de modo que 'output_file' nunca queda escrito a medias.
+static void child_save(const Node *root, const char *output_file, bool compact)
+{
+    // El flujo de errores del modo en tubería depende de hilos que el hijo no tiene
+    set_error_stream(stderr);
+
+    char tmp_file[MAX_PATH_LEN + 32];
+    snprintf(tmp_file, sizeof(tmp_file), "%s.tmp.%d", output_file, (int)getpid());
+
+    FILE *file = fopen(tmp_file, "w");
+    if (!file)
+    {
+        perror("Error al abrir el archivo temporal");
+        _exit(1);
+    }
+
+    // Si falta algún directorio desalojado la copia no sirve: el padre la ve fallida
+    bool ok = compact ? write_preorder_compact(file, root) : write_preorder(file, root, "");
+    if (fclose(file) != 0)
+        ok = false;
+    if (ok && rename(tmp_file, output_file) != 0)
+    {
+        perror("Error al renombrar el archivo temporal");
+        ok = false;
+    }
+    if (!ok)
+        unlink(tmp_file);
+    _exit(ok ? 0 : 1);
+}
+
+pid_t save_in_background(const Node *root, const char *output_file, bool compact, double *pause_ms)
+{
+    // El hijo termina con _exit, así que nunca vacía los buffers de stdio que
+    // hereda y no hace falta vaciarlos aquí. Eso tampoco se podría hacer en el
+    // modo en tubería, donde stdout y stderr son de la etapa de escritura; esa
+    // etapa se detiene durante el fork (ver pipeline.c).
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid_t pid = fork();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (pid == 0)
+        child_save(root, output_file, compact);
+    if (pid > 0)
+        spill_file_pin();
+
+    if (pause_ms)
+        *pause_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 +
+                    (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+    return pid;
+}
+
+SaveStatus poll_background_save(pid_t pid, bool block)
+{
+    int status;
+    pid_t done;
+    do
+        done = waitpid(pid, &status, block ? 0 : WNOHANG);
+    while (done < 0 && errno == EINTR);
+    if (done == 0)
+        return SAVE_RUNNING;
+    // El hijo ya no lee el archivo de desalojo
+    spill_file_unpin();
+
+    if (done == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        return SAVE_OK;
+    return SAVE_FAILED;
+}
@@ -1,5 +1,14 @@
 #include "include/commands.h"
 #include "include/node.h"
+#include "include/bgsave.h"
+#include "include/import.h"
+#include "include/expand.h"
+#include "include/name_set.h"
+#include "include/time_index.h"
+#include "include/name_index.h"
+#include <errno.h>
+#include <fnmatch.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,6 +26,12 @@ FileSystem *init_filesystem()
 
     fs->root = create_node("/", DIR_TYPE, NULL);
     fs->current_dir = fs->root;
+    fs->out = stdout;
+    fs->err = stderr;
+    fs->bgsave_pid = 0;
+    fs->last_save = 0;
+    fs->last_save_ok = false;
+    fs->last_pause_ms = 0.0;
 
     if (!fs->root)
     {
@@ -33,11 +48,10 @@ bool touch(FileSystem *fs, const char *path)
     if (!fs || !path)
         return false;
 
-    // Verifica si el archivo ya existe
-    Node *existing_node = find_node(fs->current_dir, path, FILE_TYPE);
-    if (existing_node)
+    // Verifica si el archivo ya existe en el directorio actual
+    if (has_child_named(fs->current_dir, path, FILE_TYPE))
     {
-        fprintf(stderr, "Error: El archivo '%s' ya existe.\n", path);
+        fprintf(fs->err, "Error: El archivo '%s' ya existe.\n", path);
         return false;
     }
 
@@ -46,7 +60,11 @@ bool touch(FileSystem *fs, const char *path)
     if (!new_file)
         return false;
 
-    add_child(fs->current_dir, new_file);
+    if (!add_child(fs->current_dir, new_file))
+    {
+        free_tree(new_file);
+        return false;
+    }
     return true;
 }
 
@@ -56,11 +74,10 @@ bool mkdir(FileSystem *fs, const char *path)
     if (!fs || !path)
         return false;
 
-    // Verifica si el directorio ya existe
-    Node *existing_node = find_node(fs->current_dir, path, DIR_TYPE);
-    if (existing_node)
+    // Verifica si el directorio ya existe en el directorio actual
+    if (has_child_named(fs->current_dir, path, DIR_TYPE))
     {
-        fprintf(stderr, "Error: El directorio '%s' ya existe.\n", path);
+        fprintf(fs->err, "Error: El directorio '%s' ya existe.\n", path);
         return false;
     }
 
@@ -69,22 +86,26 @@ bool mkdir(FileSystem *fs, const char *path)
     if (!new_dir)
         return false;
 
-    add_child(fs->current_dir, new_dir);
+    if (!add_child(fs->current_dir, new_dir))
+    {
+        free_tree(new_dir);
+        return false;
+    }
     return true;
 }
 
-// Elimina un archivo en la ruta especificada
+// Elimina un archivo del directorio actual
 bool rm(FileSystem *fs, const char *path)
 {
     if (!fs || !path)
         return false;
 
-    // Busca el archivo en el árbol
-    Node *file_to_remove = find_node(fs->current_dir, path, FILE_TYPE);
+    // Igual que rm con varios nombres, solo busca en el directorio actual
+    Node *file_to_remove = find_child(fs->current_dir, path, FILE_TYPE);
 
-    if (!file_to_remove || get_node_type(file_to_remove) != FILE_TYPE)
+    if (!file_to_remove)
     {
-        fprintf(stderr, "Error: El archivo no existe o es un directorio.\n");
+        fprintf(fs->err, "Error: El archivo no existe o es un directorio.\n");
         return false;
     }
 
@@ -92,6 +113,105 @@ bool rm(FileSystem *fs, const char *path)
     return true;
 }
 
+// Expande todos los argumentos en una sola lista de nombres
+static bool expand_args(const FileSystem *fs, char *const *args, size_t count, WordList *names)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!expand_braces(args[i], names))
+        {
+            if (names->overflow)
+                fprintf(fs->err, "Error: La expansión supera %d palabras.\n", MAX_EXPANSION);
+            free_word_list(names);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Crea en el directorio actual todos los archivos (o directorios) que resultan
+// de expandir los argumentos, con una única inserción en lote
+bool create_batch(FileSystem *fs, char *const *args, size_t count, NodeType type)
+{
+    if (!fs || !args)
+        return false;
+
+    WordList names = {NULL, 0, 0, false};
+    if (!expand_args(fs, args, count, &names))
+        return false;
+
+    size_t created = add_children(fs->current_dir, (const char *const *)names.words, names.count, type);
+    bool all_created = (created == names.count);
+    if (!all_created)
+    {
+        fprintf(fs->err, "Error: %zu de %zu %s ya existían.\n", names.count - created, names.count,
+                type == DIR_TYPE ? "directorios" : "archivos");
+    }
+
+    free_word_list(&names);
+    return all_created;
+}
+
+// Criterio de rm en lote: nombres exactos y patrones con comodines
+typedef struct
+{
+    NameSet *names;
+    char **patterns;
+    size_t pattern_count;
+} RmMatcher;
+
+static bool rm_matches(const char *name, void *ctx)
+{
+    const RmMatcher *matcher = ctx;
+    if (name_set_contains(matcher->names, name))
+        return true;
+    for (size_t i = 0; i < matcher->pattern_count; i++)
+    {
+        if (fnmatch(matcher->patterns[i], name, 0) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Elimina los archivos del directorio actual que coinciden con los argumentos
+// expandidos, en una sola pasada por sus hijos
+bool rm_batch(FileSystem *fs, char *const *args, size_t count)
+{
+    if (!fs || !args)
+        return false;
+
+    WordList words = {NULL, 0, 0, false};
+    if (!expand_args(fs, args, count, &words))
+        return false;
+
+    RmMatcher matcher = {name_set_create(words.count), NULL, 0};
+    matcher.patterns = malloc(words.count * sizeof(char *));
+    if (!matcher.names || !matcher.patterns)
+    {
+        fprintf(fs->err, "Error al asignar memoria para rm: %s\n", strerror(errno));
+        name_set_free(matcher.names);
+        free(matcher.patterns);
+        free_word_list(&words);
+        return false;
+    }
+    for (size_t i = 0; i < words.count; i++)
+    {
+        if (has_glob(words.words[i]))
+            matcher.patterns[matcher.pattern_count++] = words.words[i];
+        else
+            name_set_insert(matcher.names, words.words[i]);
+    }
+
+    size_t removed = remove_children_if(fs->current_dir, FILE_TYPE, rm_matches, &matcher);
+    if (removed == 0)
+        fprintf(fs->err, "Error: Ningún archivo coincide.\n");
+
+    name_set_free(matcher.names);
+    free(matcher.patterns);
+    free_word_list(&words);
+    return removed > 0;
+}
+
 // Elimina un directorio vacío en la ruta especificada
 bool rmdir(FileSystem *fs, const char *path)
 {
@@ -103,14 +223,14 @@ bool rmdir(FileSystem *fs, const char *path)
 
     if (!dir_to_remove || get_node_type(dir_to_remove) != DIR_TYPE)
     {
-        fprintf(stderr, "Error: El directorio no existe o no está vacío.\n");
+        fprintf(fs->err, "Error: El directorio no existe o no está vacío.\n");
         return false;
     }
 
     // Verifica que el directorio esté vacío
     if (get_first_child(dir_to_remove))
     {
-        fprintf(stderr, "Error: El directorio no está vacío.\n");
+        fprintf(fs->err, "Error: El directorio no está vacío.\n");
         return false;
     }
 
@@ -118,48 +238,101 @@ bool rmdir(FileSystem *fs, const char *path)
     return true;
 }
 
-// Lista los archivos y directorios en la ruta especificada
+// Opciones de ls que recibe cada entrada a imprimir
+typedef struct
+{
+    FILE *out;
+    bool long_listing;
+} ListingOptions;
+
+// Imprime una entrada de ls (con -l agrega tipo y fecha de creación)
+static bool print_ls_entry(Node *child, void *ctx)
+{
+    const ListingOptions *options = ctx;
+    if (options->long_listing)
+    {
+        // Formatear la fecha y hora de creación
+        char time_str[20];
+        time_t creation_time = get_creation_time(child);
+        struct tm *timeinfo = localtime(&creation_time);
+        strftime(time_str, sizeof(time_str), "%H:%M-%d/%m/%Y", timeinfo);
+
+        // Imprimir detalles adicionales (nombre, tipo, fecha de creación)
+        fprintf(options->out, "%s\t%s\t%s\n",
+               get_node_name(child),
+               (get_node_type(child) == DIR_TYPE ? "DIR" : "FILE"),
+               time_str);
+    }
+    else
+    {
+        fprintf(options->out, "%s\n", get_node_name(child));
+    }
+    return true;
+}
+
+// Indica si 'path' es de la forma <prefijo>* (sin otros comodines)
+static bool is_prefix_pattern(const char *path, char *prefix, size_t size)
+{
+    size_t len = strlen(path);
+    if (len == 0 || path[len - 1] != '*' || len > size)
+        return false;
+
+    memcpy(prefix, path, len - 1);
+    prefix[len - 1] = '\0';
+    return !has_glob(prefix);
+}
+
+// Lista los archivos y directorios en la ruta especificada. 'ls <prefijo>*'
+// lista, en orden alfabético, los hijos del directorio actual con ese prefijo.
 void ls(const FileSystem *fs, const char *path, bool long_listing)
 {
     if (!fs)
         return;
 
+    ListingOptions options = {fs->out, long_listing};
     Node *target_dir = fs->current_dir;
 
+    char prefix[MAX_PATH_LEN];
+    if (path && is_prefix_pattern(path, prefix, sizeof(prefix)))
+    {
+        mark_accessed(target_dir);
+        if (find_children_with_prefix(target_dir, prefix, print_ls_entry, &options) == 0)
+            fprintf(fs->err, "Error: No hay archivos ni directorios que empiecen con '%s'.\n", prefix);
+        return;
+    }
+
     // Si se especifica un path, buscar el directorio correspondiente
     if (path)
     {
         target_dir = find_node(fs->current_dir, path, DIR_TYPE);
         if (!target_dir)
         {
-            fprintf(stderr, "Error: El directorio '%s' no existe.\n", path);
+            fprintf(fs->err, "Error: El directorio '%s' no existe.\n", path);
             return;
         }
     }
 
-    Node *child = get_first_child(target_dir);
-    while (child)
-    {
-        if (long_listing)
-        {
-            // Formatear la fecha y hora de creación
-            char time_str[20];
-            time_t creation_time = get_creation_time(child);
-            struct tm *timeinfo = localtime(&creation_time);
-            strftime(time_str, sizeof(time_str), "%H:%M-%d/%m/%Y", timeinfo);
-
-            // Imprimir detalles adicionales (nombre, tipo, fecha de creación)
-            printf("%s\t%s\t%s\n",
-                   get_node_name(child),
-                   (get_node_type(child) == DIR_TYPE ? "DIR" : "FILE"),
-                   time_str);
-        }
-        else
-        {
-            printf("%s\n", get_node_name(child));
-        }
-        child = get_next_sibling(child);
-    }
+    mark_accessed(target_dir);
+    for (Node *child = get_first_child(target_dir); child; child = get_next_sibling(child))
+        print_ls_entry(child, &options);
+}
+
+// Imprime un candidato de complete (los directorios terminan en '/')
+static bool print_completion(Node *node, void *ctx)
+{
+    fprintf((FILE *)ctx, "%s%s\n", get_node_name(node), get_node_type(node) == DIR_TYPE ? "/" : "");
+    return true;
+}
+
+// Muestra los nombres del directorio actual que empiezan con 'prefix', para
+// completar un nombre a medio escribir
+void complete(const FileSystem *fs, const char *prefix)
+{
+    if (!fs || !prefix)
+        return;
+
+    mark_accessed(fs->current_dir);
+    find_children_with_prefix(fs->current_dir, prefix, print_completion, fs->out);
 }
 
 // Cambia el directorio actual
@@ -174,7 +347,7 @@ bool cd(FileSystem *fs, const char *path)
         Node *parent = get_parent(fs->current_dir);
         if (!parent)
         {
-            fprintf(stderr, "Error: No hay directorio padre (ya estás en la raíz).\n");
+            fprintf(fs->err, "Error: No hay directorio padre (ya estás en la raíz).\n");
             return false;
         }
         fs->current_dir = parent;
@@ -193,10 +366,11 @@ bool cd(FileSystem *fs, const char *path)
 
     if (!target_dir || get_node_type(target_dir) != DIR_TYPE)
     {
-        fprintf(stderr, "Error: El directorio no existe.\n");
+        fprintf(fs->err, "Error: El directorio no existe.\n");
         return false;
     }
 
+    mark_accessed(target_dir);
     fs->current_dir = target_dir;
     return true;
 }
@@ -234,7 +408,7 @@ void pwd(const FileSystem *fs)
         current = get_parent(current);
     }
 
-    printf("%s\n", path);
+    fprintf(fs->out, "%s\n", path);
 }
 
 // Guarda el sistema de archivos en un archivo de texto
@@ -246,31 +420,358 @@ bool wrts(const FileSystem *fs, const char *output_file)
     FILE *file = fopen(output_file, "w");
     if (!file)
     {
-        perror("Error al abrir el archivo");
+        fprintf(fs->err, "Error al abrir el archivo: %s\n", strerror(errno));
         return false;
     }
 
     // Se recorre el árbol en preorden, iniciando en la raíz.
-    write_preorder(file, fs->root, "");
+    bool ok = write_preorder(file, fs->root, "");
+
+    if (fclose(file) != 0)
+        ok = false;
+    return ok;
+}
+
+// Guarda el sistema de archivos en formato compacto: cada línea guarda solo el
+// sufijo de su camino que difiere de la línea anterior y la fecha como diferencia
+bool wrts_compact(const FileSystem *fs, const char *output_file)
+{
+    if (!fs || !output_file)
+        return false;
+
+    FILE *file = fopen(output_file, "w");
+    if (!file)
+    {
+        fprintf(fs->err, "Error al abrir el archivo: %s\n", strerror(errno));
+        return false;
+    }
+
+    bool ok = write_preorder_compact(file, fs->root);
+
+    if (fclose(file) != 0)
+        ok = false;
+    return ok;
+}
+
+// Recoge el resultado del bgsave en curso, si ya terminó. Con 'block' espera a que termine.
+static void bgsave_poll(FileSystem *fs, bool block)
+{
+    if (fs->bgsave_pid <= 0)
+        return;
+
+    SaveStatus status = poll_background_save(fs->bgsave_pid, block);
+    if (status == SAVE_RUNNING)
+        return;
+
+    fs->last_save_ok = (status == SAVE_OK);
+    fs->last_save = time(NULL);
+    fs->bgsave_pid = 0;
+}
+
+// Guarda el sistema de archivos en segundo plano. El hijo creado con fork
+// escribe su copia (copy-on-write) del árbol mientras el padre sigue atendiendo comandos.
+bool bgsave(FileSystem *fs, const char *output_file, bool compact)
+{
+    if (!fs || !output_file)
+        return false;
+
+    bgsave_poll(fs, false);
+    if (fs->bgsave_pid > 0)
+    {
+        fprintf(fs->err, "Error: Ya hay un guardado en segundo plano en curso (pid %d).\n", (int)fs->bgsave_pid);
+        return false;
+    }
+
+    // El hijo hereda los buffers de salida: se vacían antes del fork
+    fflush(fs->out);
+
+    double pause_ms;
+    pid_t pid = save_in_background(fs->root, output_file, compact, &pause_ms);
+    if (pid < 0)
+    {
+        fprintf(fs->err, "Error al crear el proceso de guardado: %s\n", strerror(errno));
+        return false;
+    }
+
+    fs->bgsave_pid = pid;
+    fs->last_pause_ms = pause_ms;
+    fprintf(fs->out, "Guardado en segundo plano iniciado (pid %d, pausa %.3f ms).\n", (int)pid, pause_ms);
+    return true;
+}
+
+// Muestra el estado del último guardado en segundo plano
+void lastsave(FileSystem *fs)
+{
+    if (!fs)
+        return;
+
+    bgsave_poll(fs, false);
+    if (fs->bgsave_pid > 0)
+    {
+        fprintf(fs->out, "Guardado en segundo plano en curso (pid %d, pausa %.3f ms).\n",
+               (int)fs->bgsave_pid, fs->last_pause_ms);
+        return;
+    }
+
+    if (fs->last_save == 0)
+    {
+        fprintf(fs->out, "No se ha realizado ningún guardado en segundo plano.\n");
+        return;
+    }
+
+    char time_str[20];
+    struct tm *timeinfo = localtime(&fs->last_save);
+    strftime(time_str, sizeof(time_str), "%H:%M-%d/%m/%Y", timeinfo);
+    fprintf(fs->out, "Último guardado: %s (%s, pausa %.3f ms).\n", time_str,
+           fs->last_save_ok ? "correcto" : "fallido", fs->last_pause_ms);
+}
+
+// Importa un directorio real del host bajo 'target' (o el directorio actual)
+bool import_dir(FileSystem *fs, const char *host_dir, const char *target)
+{
+    if (!fs || !host_dir)
+        return false;
+
+    Node *target_dir = fs->current_dir;
+    if (target)
+    {
+        target_dir = find_node(fs->current_dir, target, DIR_TYPE);
+        if (!target_dir)
+        {
+            fprintf(fs->err, "Error: El directorio '%s' no existe.\n", target);
+            return false;
+        }
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ImportStats stats;
+    if (!import_host_directory(target_dir, host_dir, &stats))
+        return false;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(fs->out, "Importados %ld nodos de '%s' en %.3f s (%d hilos).\n", stats.nodes, host_dir, seconds, stats.threads);
+    if (stats.errors > 0)
+        fprintf(fs->err, "Advertencia: %ld entradas no se pudieron leer.\n", stats.errors);
+    return true;
+}
+
+// Interpreta una fecha en el formato de 'ls -l' (HH:MM-DD/MM/AAAA) o como
+// segundos desde la época con '@' (por ejemplo @1760000000)
+bool parse_time(const char *text, time_t *result)
+{
+    if (!text || !result)
+        return false;
+
+    if (text[0] == '@')
+    {
+        char *end;
+        long long seconds = strtoll(text + 1, &end, 10);
+        if (end == text + 1 || *end != '\0')
+            return false;
+        *result = (time_t)seconds;
+        return true;
+    }
+
+    struct tm tm = {0};
+    char extra;
+    if (sscanf(text, "%d:%d-%d/%d/%d%c", &tm.tm_hour, &tm.tm_min, &tm.tm_mday, &tm.tm_mon, &tm.tm_year, &extra) != 5)
+        return false;
+    tm.tm_mon -= 1;
+    tm.tm_year -= 1900;
+    tm.tm_isdst = -1;
+    *result = mktime(&tm);
+    return *result != (time_t)-1;
+}
 
-    fclose(file);
+// Imprime el camino absoluto de un nodo devuelto por el índice de fechas
+static bool print_node_path(Node *node, void *ctx)
+{
+    FILE *out = ctx;
+    char path[MAX_PATH_LEN];
+    get_node_path(node, path, sizeof(path));
+    fprintf(out, "%s\n", path);
+    return true;
+}
+
+// Imprime camino, tipo y fecha de creación (como 'ls -l')
+static bool print_node_details(Node *node, void *ctx)
+{
+    FILE *out = ctx;
+    char path[MAX_PATH_LEN];
+    get_node_path(node, path, sizeof(path));
+
+    char time_str[20];
+    time_t creation_time = get_creation_time(node);
+    struct tm *timeinfo = localtime(&creation_time);
+    strftime(time_str, sizeof(time_str), "%H:%M-%d/%m/%Y", timeinfo);
+
+    fprintf(out, "%s\t%s\t%s\n", path, (get_node_type(node) == DIR_TYPE ? "DIR" : "FILE"), time_str);
     return true;
 }
 
+// Lista los nodos creados estrictamente después de 'newer_than' y antes de
+// 'older_than', en orden de creación
+void find_by_time(const FileSystem *fs, time_t newer_than, time_t older_than)
+{
+    // Los extremos no se incluyen; en los valores límite el rango queda vacío y
+    // ajustarlos desbordaría time_t
+    if (!fs || newer_than == (time_t)INT64_MAX || older_than == (time_t)INT64_MIN ||
+        newer_than >= older_than - 1)
+        return;
+
+    // El índice solo conoce los nodos residentes
+    load_spilled_in_range(newer_than + 1, older_than - 1);
+    time_index_range(newer_than + 1, older_than - 1, print_node_path, fs->out);
+}
+
+// Guarda la fecha del último nodo visitado
+static bool remember_time(Node *node, void *ctx)
+{
+    *(time_t *)ctx = get_creation_time(node);
+    return true;
+}
+
+// Lista los 'count' nodos creados más recientemente, del más nuevo al más viejo
+void recent(const FileSystem *fs, size_t count)
+{
+    if (!fs || count == 0)
+        return;
+
+    // Se recargan los subárboles desalojados con nodos al menos tan nuevos como
+    // el n-ésimo residente, hasta que ninguno más pueda entrar en el resultado
+    time_t oldest;
+    do
+    {
+        oldest = (time_t)INT64_MIN;
+        if (time_index_recent(count, remember_time, &oldest) < count)
+            oldest = (time_t)INT64_MIN;
+    } while (load_spilled_in_range(oldest, (time_t)INT64_MAX) > 0);
+
+    time_index_recent(count, print_node_details, fs->out);
+}
+
+// Imprime el camino absoluto de todos los nodos llamados 'name'
+void locate(const FileSystem *fs, const char *name)
+{
+    if (!fs || !name)
+        return;
+
+    load_spilled_named(name);
+    if (name_index_lookup(name, print_node_path, fs->out) == 0)
+        fprintf(fs->err, "Error: No hay nodos llamados '%s'.\n", name);
+}
+
+// Muestra cuánta memoria ocupa el índice de nombres
+void locate_stats(const FileSystem *fs)
+{
+    if (!fs)
+        return;
+
+    NameIndexStats stats;
+    name_index_stats(&stats);
+
+    // Además de sus propias estructuras, el índice agrega un puntero a cada nodo
+    size_t node_bytes = stats.entries * sizeof(NameEntry *);
+    size_t total = stats.table_bytes + stats.child_table_bytes + stats.entry_bytes + node_bytes;
+    fprintf(fs->out, "Nombres distintos: %zu\n", stats.names);
+    fprintf(fs->out, "Nodos indexados: %zu\n", stats.entries);
+    fprintf(fs->out, "Tabla de nombres: %zu bytes\n", stats.table_bytes);
+    fprintf(fs->out, "Tabla (padre, nombre): %zu bytes\n", stats.child_table_bytes);
+    fprintf(fs->out, "Entradas: %zu bytes\n", stats.entry_bytes);
+    fprintf(fs->out, "Punteros en los nodos: %zu bytes\n", node_bytes);
+    fprintf(fs->out, "Total: %zu bytes (%.1f bytes por nodo)\n", total,
+           stats.entries ? (double)total / (double)stats.entries : 0.0);
+}
+
+// Mejor tiempo, en milisegundos, de varios recorridos completos del árbol
+static double time_traversal(const Node *root, size_t *visited)
+{
+    double best = 0.0;
+    for (int i = 0; i < 5; i++)
+    {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        *visited = traverse_tree(root);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+        if (i == 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+// Reubica todo el árbol en un bloque contiguo en preorden y mide cuánto
+// cuesta recorrerlo antes y después
+void compact(FileSystem *fs)
+{
+    if (!fs)
+        return;
+
+    size_t nodes;
+    double before = time_traversal(fs->root, &nodes);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fs->root = compact_tree(fs->root, &fs->current_dir);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double compact_ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+
+    double after = time_traversal(fs->root, &nodes);
+    fprintf(fs->out, "Compactados %zu nodos en %.3f ms.\n", nodes, compact_ms);
+    fprintf(fs->out, "Recorrido completo: %.3f ms antes, %.3f ms después (%.1f Mnodos/s).\n", before, after,
+            after > 0.0 ? (double)nodes / after / 1e3 : 0.0);
+}
+
+// Muestra la memoria usada y el estado del desalojo de subárboles (--mem-limit)
+void memstats(const FileSystem *fs)
+{
+    if (!fs)
+        return;
+
+    MemoryStats stats;
+    get_memory_stats(&stats);
+
+    size_t total = stats.node_bytes + stats.time_index_bytes + stats.name_index_bytes + stats.stub_bytes;
+    if (stats.limit)
+        fprintf(fs->out, "Límite: %zu bytes\n", stats.limit);
+    else
+        fprintf(fs->out, "Límite: ninguno\n");
+    fprintf(fs->out, "Nodos residentes: %zu bytes\n", stats.node_bytes);
+    fprintf(fs->out, "Índice de fechas: %zu bytes\n", stats.time_index_bytes);
+    fprintf(fs->out, "Índice de nombres: %zu bytes\n", stats.name_index_bytes);
+    fprintf(fs->out, "Stubs: %zu bytes\n", stats.stub_bytes);
+    fprintf(fs->out, "Total: %zu bytes\n", total);
+    fprintf(fs->out, "Directorios desalojados: %zu (%zu nodos)\n", stats.spilled_dirs, stats.spilled_nodes);
+    fprintf(fs->out, "Archivo de desalojo: %zu bytes\n", stats.spill_file_bytes);
+    fprintf(fs->out, "Desalojos: %zu, recargas: %zu\n", stats.spills, stats.faults);
+}
+
 // Muestra una lista de comandos disponibles
-void help()
+void help(const FileSystem *fs)
 {
-    printf("Comandos disponibles:\n");
-    printf("  touch <nombre_archivo> - Crea un archivo.\n");
-    printf("  mkdir <nombre_directorio> - Crea un directorio.\n");
-    printf("  rm <nombre_archivo> - Elimina un archivo.\n");
-    printf("  rmdir <nombre_directorio> - Elimina un directorio vacío.\n");
-    printf("  ls [-l] <nombre_directorio> - Lista archivos y directorios. Cuando se usa la opción -l se listan los elementos del directorio dado mostrando: nombre fecha de creación y si es un archivo o directorio\n");
-    printf("  cd <nombre_directorio> - Cambia el directorio actual.\n");
-    printf("  pwd - Muestra la ruta absoluta del directorio actual.\n");
-    printf("  wrts <nombre_archivo> - Guarda el sistema de archivos en un archivo.\n");
-    printf("  help - Muestra esta ayuda.\n");
-    printf("  exit - Termina el programa.\n");
+    fprintf(fs->out, "Comandos disponibles:\n");
+    fprintf(fs->out, "  touch <nombre_archivo>... - Crea archivos. Acepta llaves: f{1..100}.log, {a,b}.txt\n");
+    fprintf(fs->out, "  mkdir <nombre_directorio>... - Crea directorios. Acepta llaves: d{a..z}\n");
+    fprintf(fs->out, "  rm <nombre_archivo>... - Elimina archivos del directorio actual. Acepta llaves y comodines: *.tmp\n");
+    fprintf(fs->out, "  rmdir <nombre_directorio> - Elimina un directorio vacío.\n");
+    fprintf(fs->out, "  ls [-l] <nombre_directorio> - Lista archivos y directorios. Cuando se usa la opción -l se listan los elementos del directorio dado mostrando: nombre fecha de creación y si es un archivo o directorio\n");
+    fprintf(fs->out, "  ls [-l] <prefijo>* - Lista en orden alfabético los elementos del directorio actual que empiezan con el prefijo.\n");
+    fprintf(fs->out, "  complete <prefijo> - Muestra los nombres del directorio actual que empiezan con el prefijo (los directorios terminan en '/').\n");
+    fprintf(fs->out, "  cd <nombre_directorio> - Cambia el directorio actual.\n");
+    fprintf(fs->out, "  pwd - Muestra la ruta absoluta del directorio actual.\n");
+    fprintf(fs->out, "  wrts [--compact] <nombre_archivo> - Guarda el sistema de archivos en un archivo. Con --compact se usa el formato compacto, que también se puede cargar al iniciar.\n");
+    fprintf(fs->out, "  bgsave [--compact] <nombre_archivo> - Guarda el sistema de archivos en segundo plano.\n");
+    fprintf(fs->out, "  lastsave - Muestra el estado del último guardado en segundo plano.\n");
+    fprintf(fs->out, "  import <directorio_real> [<directorio>] - Importa un directorio del sistema real al directorio dado (o al actual).\n");
+    fprintf(fs->out, "  find [-newer <fecha>] [-older <fecha>] - Lista los nodos creados después y/o antes de la fecha (HH:MM-DD/MM/AAAA o @segundos).\n");
+    fprintf(fs->out, "  recent <n> - Lista los n nodos creados más recientemente.\n");
+    fprintf(fs->out, "  locate <nombre> - Muestra el camino de todos los nodos con ese nombre. Con --stats muestra la memoria del índice.\n");
+    fprintf(fs->out, "  compact - Reubica el árbol en memoria contigua para acelerar los recorridos (también: defrag).\n");
+    fprintf(fs->out, "  memstats - Muestra la memoria usada y cuántos subárboles están desalojados a disco (--mem-limit).\n");
+    fprintf(fs->out, "  help - Muestra esta ayuda.\n");
+    fprintf(fs->out, "  exit - Termina el programa.\n");
 }
 
 // Libera la memoria del sistema de archivos
@@ -279,6 +780,9 @@ void exit_filesystem(FileSystem *fs)
     if (!fs)
         return;
 
-    free_tree(fs->root);
+    // Espera a que termine un bgsave pendiente para no dejar el archivo a medias
+    bgsave_poll(fs, true);
+
+    free_filesystem_tree(fs->root);
     free(fs);
 }
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include "include/dispatch.h"
+#include "include/expand.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Nombre de cada comando, en el orden de CommandId
+static const char *const command_names[] = {
+    [CMD_TOUCH] = "touch",
+    [CMD_RM] = "rm",
+    [CMD_MKDIR] = "mkdir",
+    [CMD_RMDIR] = "rmdir",
+    [CMD_LS] = "ls",
+    [CMD_COMPLETE] = "complete",
+    [CMD_CD] = "cd",
+    [CMD_PWD] = "pwd",
+    [CMD_WRTS] = "wrts",
+    [CMD_BGSAVE] = "bgsave",
+    [CMD_LASTSAVE] = "lastsave",
+    [CMD_IMPORT] = "import",
+    [CMD_FIND] = "find",
+    [CMD_RECENT] = "recent",
+    [CMD_LOCATE] = "locate",
+    [CMD_COMPACT] = "compact",
+    [CMD_DEFRAG] = "defrag",
+    [CMD_MEMSTATS] = "memstats",
+    [CMD_HELP] = "help",
+    [CMD_EXIT] = "exit",
+};
+
+void parse_command(const char *line, CommandRecord *record)
+{
+    record->argc = 0;
+    record->length = 0;
+
+    // Igual que strtok con " ": se ignoran los espacios repetidos
+    const char *p = line;
+    while (*p && record->length < MAX_CMD - 1)
+    {
+        while (*p == ' ')
+            p++;
+        if (!*p)
+            break;
+
+        size_t len = strcspn(p, " ");
+        if (record->length + len + 1 > MAX_CMD)
+            len = MAX_CMD - 1 - record->length;
+        memcpy(record->text + record->length, p, len);
+        record->length += len;
+        record->text[record->length++] = '\0';
+        record->argc++;
+        p += len;
+    }
+
+    if (record->argc == 0)
+    {
+        record->id = CMD_EMPTY;
+        return;
+    }
+
+    record->id = CMD_UNKNOWN;
+    for (int id = CMD_TOUCH; id <= CMD_EXIT; id++)
+    {
+        if (strcmp(record->text, command_names[id]) == 0)
+        {
+            record->id = (uint8_t)id;
+            break;
+        }
+    }
+}
+
+// Indica si alguno de los argumentos necesita expansión de llaves o comodines
+static bool any_needs_expansion(char *const *args, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (needs_expansion(args[i]))
+            return true;
+    }
+    return false;
+}
+
+// Las opciones --compact de wrts y bgsave
+static bool take_compact_flag(char ***args, size_t *count)
+{
+    if (*count > 0 && strcmp((*args)[0], "--compact") == 0)
+    {
+        (*args)++;
+        (*count)--;
+        return true;
+    }
+    return false;
+}
+
+CommandResult execute_command(FileSystem *fs, const CommandRecord *record)
+{
+    // Reconstruir los argumentos (sin el nombre del comando)
+    char *words[MAX_ARGS + 1];
+    char *text = (char *)record->text;
+    size_t argc = 0;
+    for (size_t pos = 0; pos < record->length && argc <= MAX_ARGS; pos += strlen(text + pos) + 1)
+        words[argc++] = text + pos;
+    char **args = words + 1;
+    size_t count = argc > 0 ? argc - 1 : 0;
+    FILE *out = fs->out;
+    bool ok = true;
+
+    switch ((CommandId)record->id)
+    {
+    case CMD_EMPTY:
+        break;
+
+    // touch, mkdir y rm aceptan varios nombres, llaves y comodines; un
+    // único nombre simple conserva el comportamiento de siempre
+    case CMD_TOUCH:
+        if (count == 0)
+        {
+            fprintf(out, "Uso: touch <nombre_archivo>...\n");
+            ok = false;
+        }
+        else if (count == 1 && !any_needs_expansion(args, count))
+            ok = touch(fs, args[0]);
+        else
+            ok = create_batch(fs, args, count, FILE_TYPE);
+        break;
+
+    case CMD_RM:
+        if (count == 0)
+        {
+            fprintf(out, "Uso: rm <nombre_archivo>...\n");
+            ok = false;
+        }
+        else if (count == 1 && !any_needs_expansion(args, count))
+            ok = rm(fs, args[0]);
+        else
+            ok = rm_batch(fs, args, count);
+        break;
+
+    case CMD_MKDIR:
+        if (count == 0)
+        {
+            fprintf(out, "Uso: mkdir <nombre_directorio>...\n");
+            ok = false;
+        }
+        else if (count == 1 && !any_needs_expansion(args, count))
+            ok = mkdir(fs, args[0]);
+        else
+            ok = create_batch(fs, args, count, DIR_TYPE);
+        break;
+
+    case CMD_RMDIR:
+        if (count == 0)
+        {
+            fprintf(out, "Uso: rmdir <nombre_directorio>\n");
+            ok = false;
+        }
+        else
+            ok = rmdir(fs, args[0]);
+        break;
+
+    case CMD_LS:
+    {
+        bool long_listing = false;
+        if (count > 0 && strcmp(args[0], "-l") == 0)
+        {
+            long_listing = true;
+            args++;
+            count--;
+        }
+        ls(fs, count > 0 ? args[0] : NULL, long_listing);
+        break;
+    }
+
+    case CMD_COMPLETE:
+        // Sin prefijo se muestran todos los nombres
+        complete(fs, count > 0 ? args[0] : "");
+        break;
+
+    case CMD_CD:
+        if (count == 0)
+        {
+            fprintf(out, "Uso: cd <nombre_directorio>\n");
+            ok = false;
+        }
+        else
+            ok = cd(fs, args[0]);
+        break;
+
+    case CMD_PWD:
+        pwd(fs);
+        break;
+
+    case CMD_WRTS:
+    {
+        bool compact = take_compact_flag(&args, &count);
+        if (count == 0)
+        {
+            fprintf(out, "Uso: wrts [--compact] <nombre_del_archivo>\n");
+            ok = false;
+        }
+        else if (!(compact ? wrts_compact(fs, args[0]) : wrts(fs, args[0])))
+        {
+            fprintf(out, "Error al escribir el sistema de archivos.\n");
+            ok = false;
+        }
+        break;
+    }
+
+    case CMD_BGSAVE:
+    {
+        bool compact = take_compact_flag(&args, &count);
+        if (count == 0)
+        {
+            fprintf(out, "Uso: bgsave [--compact] <nombre_del_archivo>\n");
+            ok = false;
+        }
+        else
+            ok = bgsave(fs, args[0], compact);
+        break;
+    }
+
+    case CMD_LASTSAVE:
+        lastsave(fs);
+        break;
+
+    case CMD_IMPORT:
+        if (count == 0)
+        {
+            fprintf(out, "Uso: import <directorio_real> [<directorio>]\n");
+            ok = false;
+        }
+        else
+            ok = import_dir(fs, args[0], count > 1 ? args[1] : NULL);
+        break;
+
+    case CMD_FIND:
+    {
+        time_t newer_than = (time_t)INT64_MIN;
+        time_t older_than = (time_t)INT64_MAX;
+        bool valid = count > 0;
+        for (size_t i = 0; valid && i < count; i += 2)
+        {
+            const char *value = (i + 1 < count) ? args[i + 1] : NULL;
+            if (strcmp(args[i], "-newer") == 0)
+                valid = parse_time(value, &newer_than);
+            else if (strcmp(args[i], "-older") == 0)
+                valid = parse_time(value, &older_than);
+            else
+                valid = false;
+        }
+        if (!valid)
+        {
+            fprintf(out, "Uso: find [-newer <fecha>] [-older <fecha>] (fecha: HH:MM-DD/MM/AAAA o @segundos)\n");
+            ok = false;
+        }
+        else
+            find_by_time(fs, newer_than, older_than);
+        break;
+    }
+
+    case CMD_RECENT:
+    {
+        char *end = NULL;
+        long n = count > 0 ? strtol(args[0], &end, 10) : -1;
+        if (count == 0 || *end != '\0' || n < 0)
+        {
+            fprintf(out, "Uso: recent <n>\n");
+            ok = false;
+        }
+        else
+            recent(fs, (size_t)n);
+        break;
+    }
+
+    case CMD_LOCATE:
+        if (count == 0)
+        {
+            fprintf(out, "Uso: locate <nombre> | locate --stats\n");
+            ok = false;
+        }
+        else if (strcmp(args[0], "--stats") == 0)
+            locate_stats(fs);
+        else
+            locate(fs, args[0]);
+        break;
+
+    case CMD_COMPACT:
+    case CMD_DEFRAG:
+        compact(fs);
+        break;
+
+    case CMD_MEMSTATS:
+        memstats(fs);
+        break;
+
+    case CMD_HELP:
+        help(fs);
+        break;
+
+    case CMD_EXIT:
+        return RESULT_EXIT;
+
+    case CMD_UNKNOWN:
+    default:
+        fprintf(out, "Comando desconocido. Escriba 'help' para ver los comandos disponibles.\n");
+        ok = false;
+        break;
+    }
+
+    // Con --mem-limit, desaloja a disco los subárboles fríos si hace falta
+    enforce_memory_limit(fs->root, fs->current_dir);
+    return ok ? RESULT_OK : RESULT_ERROR;
+}
@@ -0,0 +1,21 @@
+#include "include/error.h"
+#include <errno.h>
+#include <string.h>
+
+static FILE *stream;
+
+void set_error_stream(FILE *err)
+{
+    stream = err;
+}
+
+FILE *error_stream()
+{
+    return stream ? stream : stderr;
+}
+
+void report_errno(const char *message)
+{
+    int saved = errno;
+    fprintf(error_stream(), "%s: %s\n", message, strerror(saved));
+}
@@ -0,0 +1,216 @@
+#include "include/expand.h"
+#include "include/error.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool push_word(WordList *list, char *word)
+{
+    if (list->count >= MAX_EXPANSION)
+    {
+        list->overflow = true;
+        free(word);
+        return false;
+    }
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        char **words = realloc(list->words, capacity * sizeof(char *));
+        if (!words)
+        {
+            report_errno("Error al asignar memoria para la expansión");
+            free(word);
+            return false;
+        }
+        list->words = words;
+        list->capacity = capacity;
+    }
+    list->words[list->count++] = word;
+    return true;
+}
+
+// Busca la llave de cierre que corresponde a la de apertura en 'open'
+static const char *matching_brace(const char *open)
+{
+    int depth = 0;
+    for (const char *p = open; *p; p++)
+    {
+        if (*p == '{')
+            depth++;
+        else if (*p == '}' && --depth == 0)
+            return p;
+    }
+    return NULL;
+}
+
+// Concatena prefijo + medio + sufijo y sigue expandiendo el resultado
+static bool expand_part(const char *prefix, size_t prefix_len, const char *middle, size_t middle_len,
+                        const char *suffix, WordList *list)
+{
+    size_t suffix_len = strlen(suffix);
+    char *word = malloc(prefix_len + middle_len + suffix_len + 1);
+    if (!word)
+    {
+        report_errno("Error al asignar memoria para la expansión");
+        return false;
+    }
+    memcpy(word, prefix, prefix_len);
+    memcpy(word + prefix_len, middle, middle_len);
+    memcpy(word + prefix_len + middle_len, suffix, suffix_len + 1);
+
+    // Si el sufijo no tiene más llaves la palabra ya está completa
+    if (!strchr(suffix, '{'))
+        return push_word(list, word);
+
+    bool ok = expand_braces(word, list);
+    free(word);
+    return ok;
+}
+
+// Intenta expandir un rango {x..y}. Devuelve false si 'body' no es un rango.
+static bool expand_range(const char *prefix, size_t prefix_len, const char *body, size_t body_len,
+                         const char *suffix, WordList *list, bool *ok)
+{
+    char text[64];
+    if (body_len >= sizeof(text))
+        return false;
+    memcpy(text, body, body_len);
+    text[body_len] = '\0';
+
+    char *dots = strstr(text, "..");
+    if (!dots || dots == text || dots[2] == '\0')
+        return false;
+    *dots = '\0';
+    const char *from = text;
+    const char *to = dots + 2;
+
+    char *end_from, *end_to;
+    long a = strtol(from, &end_from, 10);
+    long b = strtol(to, &end_to, 10);
+    char buffer[32];
+
+    if (*end_from == '\0' && *end_to == '\0')
+    {
+        // Rango numérico; si algún extremo tiene ceros a la izquierda se rellena
+        int width = 0;
+        if ((from[0] == '0' && from[1]) || (to[0] == '0' && to[1]))
+            width = (int)(strlen(from) > strlen(to) ? strlen(from) : strlen(to));
+        long step = (a <= b) ? 1 : -1;
+        for (long i = a;; i += step)
+        {
+            int len = snprintf(buffer, sizeof(buffer), "%0*ld", width, i);
+            if (!expand_part(prefix, prefix_len, buffer, (size_t)len, suffix, list))
+            {
+                *ok = false;
+                return true;
+            }
+            if (i == b)
+                break;
+        }
+        *ok = true;
+        return true;
+    }
+
+    if (strlen(from) == 1 && strlen(to) == 1 && isalpha((unsigned char)from[0]) && isalpha((unsigned char)to[0]))
+    {
+        // Rango de letras
+        int step = (from[0] <= to[0]) ? 1 : -1;
+        for (int c = from[0];; c += step)
+        {
+            buffer[0] = (char)c;
+            if (!expand_part(prefix, prefix_len, buffer, 1, suffix, list))
+            {
+                *ok = false;
+                return true;
+            }
+            if (c == to[0])
+                break;
+        }
+        *ok = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool expand_braces(const char *word, WordList *list)
+{
+    // Busca el primer grupo {..} que sea una lista con comas o un rango
+    for (const char *open = strchr(word, '{'); open; open = strchr(open + 1, '{'))
+    {
+        const char *close = matching_brace(open);
+        if (!close)
+            break;
+
+        const char *body = open + 1;
+        size_t body_len = (size_t)(close - body);
+        size_t prefix_len = (size_t)(open - word);
+
+        bool ok;
+        if (expand_range(word, prefix_len, body, body_len, close + 1, list, &ok))
+            return ok;
+
+        // Lista separada por comas de primer nivel
+        bool has_comma = false;
+        int depth = 0;
+        for (const char *p = body; p < close; p++)
+        {
+            if (*p == '{')
+                depth++;
+            else if (*p == '}')
+                depth--;
+            else if (*p == ',' && depth == 0)
+                has_comma = true;
+        }
+        if (!has_comma)
+            continue;
+
+        const char *start = body;
+        depth = 0;
+        for (const char *p = body; p <= close; p++)
+        {
+            if (*p == '{')
+                depth++;
+            else if (*p == '}' && p != close)
+                depth--;
+            else if ((*p == ',' && depth == 0) || p == close)
+            {
+                if (!expand_part(word, prefix_len, start, (size_t)(p - start), close + 1, list))
+                    return false;
+                start = p + 1;
+            }
+        }
+        return true;
+    }
+
+    // Sin llaves que expandir: la palabra va tal cual
+    char *copy = strdup(word);
+    if (!copy)
+    {
+        report_errno("Error al asignar memoria para la expansión");
+        return false;
+    }
+    return push_word(list, copy);
+}
+
+void free_word_list(WordList *list)
+{
+    for (size_t i = 0; i < list->count; i++)
+        free(list->words[i]);
+    free(list->words);
+    list->words = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    list->overflow = false;
+}
+
+bool has_glob(const char *word)
+{
+    return strpbrk(word, "*?[") != NULL;
+}
+
+bool needs_expansion(const char *word)
+{
+    return strchr(word, '{') != NULL || has_glob(word);
+}
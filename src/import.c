@@ -0,0 +1,299 @@
+#define _GNU_SOURCE
+#include "include/import.h"
+#include "include/error.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define MAX_IMPORT_THREADS 16
+#define DENTS_BUFFER_SIZE (64 * 1024)
+
+// Formato de las entradas que devuelve getdents64
+struct linux_dirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// Descriptor de un directorio real compartido por las tareas de sus subdirectorios.
+// Se cierra cuando la última tarea que lo necesita ya abrió el suyo.
+typedef struct
+{
+    int fd;
+    atomic_int refs;
+} DirHandle;
+
+// Tarea: leer el directorio real 'name' (relativo a 'parent') y colgar sus
+// entradas de 'node'. La tarea raíz ya trae su directorio abierto en 'fd'.
+typedef struct ImportTask
+{
+    DirHandle *parent;
+    char *name;
+    int fd;               // -1 si hay que abrir 'name'
+    Node *node;
+    struct ImportTask *next;
+} ImportTask;
+
+// Pila de tareas compartida por los hilos. Se usa LIFO para que el recorrido
+// sea aproximadamente en profundidad y haya pocos descriptores abiertos a la vez.
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    ImportTask *stack;
+    int active;           // Tareas en proceso
+    atomic_long nodes;
+    atomic_long errors;
+} ImportQueue;
+
+static void release_handle(DirHandle *handle)
+{
+    if (handle && atomic_fetch_sub(&handle->refs, 1) == 1)
+    {
+        close(handle->fd);
+        free(handle);
+    }
+}
+
+// Fecha de creación de la entrada: btime si el sistema de archivos la guarda, si no mtime
+static bool stat_entry(int dirfd, const char *name, time_t *creation_time, bool *is_dir)
+{
+    struct statx stx;
+    if (statx(dirfd, name, AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC,
+              STATX_TYPE | STATX_BTIME | STATX_MTIME, &stx) != 0)
+        return false;
+
+    *creation_time = (stx.stx_mask & STATX_BTIME) ? (time_t)stx.stx_btime.tv_sec
+                                                  : (time_t)stx.stx_mtime.tv_sec;
+    *is_dir = S_ISDIR(stx.stx_mode);
+    return true;
+}
+
+// Lee un directorio con getdents64 y crea sus nodos. Los subdirectorios se
+// devuelven en 'subtasks' para que cualquier hilo los procese.
+static void process_task(ImportQueue *queue, ImportTask *task, ImportTask **subtasks)
+{
+    // Los subdirectorios se abren sin seguir enlaces simbólicos, así un enlace
+    // no puede sacar la importación del directorio elegido
+    int fd = task->fd;
+    if (fd < 0)
+        fd = openat(task->parent->fd, task->name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    release_handle(task->parent);
+    if (fd < 0)
+    {
+        atomic_fetch_add(&queue->errors, 1);
+        return;
+    }
+
+    DirHandle *handle = malloc(sizeof(DirHandle));
+    char *buffer = malloc(DENTS_BUFFER_SIZE);
+    if (!handle || !buffer)
+    {
+        report_errno("Error al asignar memoria para la importación");
+        free(handle);
+        free(buffer);
+        close(fd);
+        atomic_fetch_add(&queue->errors, 1);
+        return;
+    }
+    handle->fd = fd;
+    atomic_init(&handle->refs, 1);
+
+    // Solo el directorio destino puede tener hijos previos: se busca su último
+    // hijo para enlazar los nuevos en O(1) y se evitan nombres repetidos
+    // consultando la tabla (padre, nombre), sin recorrer los hermanos
+    Node *dir = task->node;
+    if (!load_children(dir))
+    {
+        free(buffer);
+        release_handle(handle);
+        atomic_fetch_add(&queue->errors, 1);
+        return;
+    }
+    bool had_children = get_first_child(dir) != NULL;
+    Node *tail = get_first_child(dir);
+    while (tail && get_next_sibling(tail))
+        tail = get_next_sibling(tail);
+
+    // Los nodos nuevos se agregan a los índices por lotes; las subtareas
+    // recién se encolan al volver, después de batch_flush
+    NodeBatch batch = {.count = 0};
+    long created = 0;
+    long nread;
+    while ((nread = syscall(SYS_getdents64, fd, buffer, DENTS_BUFFER_SIZE)) > 0)
+    {
+        for (long pos = 0; pos < nread;)
+        {
+            struct linux_dirent64 *entry = (struct linux_dirent64 *)(buffer + pos);
+            pos += entry->d_reclen;
+
+            const char *name = entry->d_name;
+            if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+                continue;
+            if (had_children && (has_child_named(dir, name, FILE_TYPE) || has_child_named(dir, name, DIR_TYPE)))
+                continue;
+
+            time_t creation_time;
+            bool is_dir;
+            if (!stat_entry(fd, name, &creation_time, &is_dir))
+            {
+                atomic_fetch_add(&queue->errors, 1);
+                continue;
+            }
+
+            Node *node = batch_create_node(&batch, name, is_dir ? DIR_TYPE : FILE_TYPE, dir, creation_time);
+            if (!node)
+            {
+                atomic_fetch_add(&queue->errors, 1);
+                continue;
+            }
+            add_child_after(dir, tail, node);
+            tail = node;
+            created++;
+
+            if (is_dir)
+            {
+                ImportTask *sub = malloc(sizeof(ImportTask));
+                char *sub_name = strdup(name);
+                if (!sub || !sub_name)
+                {
+                    free(sub);
+                    free(sub_name);
+                    atomic_fetch_add(&queue->errors, 1);
+                    continue;
+                }
+                atomic_fetch_add(&handle->refs, 1);
+                sub->parent = handle;
+                sub->name = sub_name;
+                sub->fd = -1;
+                sub->node = node;
+                sub->next = *subtasks;
+                *subtasks = sub;
+            }
+        }
+    }
+    if (nread < 0)
+        atomic_fetch_add(&queue->errors, 1);
+    batch_flush(&batch);
+
+    atomic_fetch_add(&queue->nodes, created);
+    free(buffer);
+    release_handle(handle);
+}
+
+static void *import_worker(void *arg)
+{
+    ImportQueue *queue = arg;
+
+    pthread_mutex_lock(&queue->lock);
+    for (;;)
+    {
+        while (!queue->stack && queue->active > 0)
+            pthread_cond_wait(&queue->cond, &queue->lock);
+        if (!queue->stack)
+            break; // No quedan tareas ni hilos que puedan generarlas
+
+        ImportTask *task = queue->stack;
+        queue->stack = task->next;
+        queue->active++;
+        pthread_mutex_unlock(&queue->lock);
+
+        ImportTask *subtasks = NULL;
+        process_task(queue, task, &subtasks);
+        free(task->name);
+        free(task);
+
+        pthread_mutex_lock(&queue->lock);
+        queue->active--;
+        if (subtasks)
+        {
+            ImportTask *last = subtasks;
+            while (last->next)
+                last = last->next;
+            last->next = queue->stack;
+            queue->stack = subtasks;
+        }
+        if (subtasks || queue->active == 0)
+            pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return NULL;
+}
+
+bool import_host_directory(Node *target, const char *host_dir, ImportStats *stats)
+{
+    if (!target || !host_dir || get_node_type(target) != DIR_TYPE)
+        return false;
+
+    // El directorio raíz se abre antes de lanzar los hilos y la primera tarea
+    // usa ese mismo descriptor. Se siguen los enlaces simbólicos: el usuario
+    // puede nombrar el directorio a importar con un enlace.
+    int fd = open(host_dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        report_errno("Error al abrir el directorio a importar");
+        return false;
+    }
+
+    ImportTask *root_task = malloc(sizeof(ImportTask));
+    char *root_name = strdup(host_dir);
+    if (!root_task || !root_name)
+    {
+        report_errno("Error al asignar memoria para la importación");
+        free(root_task);
+        free(root_name);
+        close(fd);
+        return false;
+    }
+    root_task->parent = NULL;
+    root_task->name = root_name;
+    root_task->fd = fd;
+    root_task->node = target;
+    root_task->next = NULL;
+
+    ImportQueue queue;
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.cond, NULL);
+    queue.stack = root_task;
+    queue.active = 0;
+    atomic_init(&queue.nodes, 0);
+    atomic_init(&queue.errors, 0);
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int num_threads = (cpus < 1) ? 1 : (cpus > MAX_IMPORT_THREADS ? MAX_IMPORT_THREADS : (int)cpus);
+
+    pthread_t threads[MAX_IMPORT_THREADS];
+    int started = 0;
+    for (int i = 0; i < num_threads; i++)
+    {
+        if (pthread_create(&threads[i], NULL, import_worker, &queue) != 0)
+            break;
+        started++;
+    }
+    // Sin hilos auxiliares la importación se hace en el hilo actual
+    if (started == 0)
+        import_worker(&queue);
+    for (int i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&queue.lock);
+    pthread_cond_destroy(&queue.cond);
+
+    if (stats)
+    {
+        stats->nodes = atomic_load(&queue.nodes);
+        stats->errors = atomic_load(&queue.errors);
+        stats->threads = started > 0 ? started : 1;
+    }
+    return true;
+}
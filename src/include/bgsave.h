@@ -0,0 +1,22 @@
+#ifndef BGSAVE_H
+#define BGSAVE_H
+
+#include "node.h"
+#include <stdbool.h>
+#include <sys/types.h>
+
+// Resultado de consultar un guardado en segundo plano
+typedef enum {
+    SAVE_RUNNING,
+    SAVE_OK,
+    SAVE_FAILED
+} SaveStatus;
+
+// Crea un proceso hijo que escribe el árbol de 'root' en 'output_file'.
+// Devuelve el pid del hijo (o -1) y en 'pause_ms' el tiempo que tardó el fork.
+pid_t save_in_background(const Node *root, const char *output_file, bool compact, double *pause_ms);
+
+// Consulta el estado del hijo 'pid'. Con 'block' espera a que termine.
+SaveStatus poll_background_save(pid_t pid, bool block);
+
+#endif
@@ -3,11 +3,19 @@
 
 #include "node.h"
 #include <stdbool.h>
+#include <sys/types.h>
+#include <time.h>
 
 // Estructura para representar el estado del sistema de archivos
 typedef struct {
     Node *root;          // Nodo raíz del sistema de archivos
     Node *current_dir;   // Directorio actual
+    FILE *out;           // Salida de los comandos (stdout, o la etapa de escritura del modo en tubería)
+    FILE *err;           // Mensajes de error de los comandos (stderr, o la etapa de escritura del modo en tubería)
+    pid_t bgsave_pid;    // Proceso hijo de bgsave en curso (0 si no hay)
+    time_t last_save;    // Fecha en que terminó el último bgsave (0 si no hay)
+    bool last_save_ok;   // Resultado del último bgsave terminado
+    double last_pause_ms; // Tiempo que el padre estuvo detenido en el último fork
 } FileSystem;
 
 // Inicializa el sistema de archivos
@@ -18,11 +26,29 @@ bool touch(FileSystem *fs, const char *path);
 bool mkdir(FileSystem *fs, const char *path);
 bool rm(FileSystem *fs, const char *path);
 bool rmdir(FileSystem *fs, const char *path);
+// Versiones en lote de touch/mkdir y rm: expanden llaves ({a,b}, {1..10}, {a..z})
+// y, en rm, comodines (*, ?, [...]) sobre los hijos del directorio actual
+bool create_batch(FileSystem *fs, char *const *args, size_t count, NodeType type);
+bool rm_batch(FileSystem *fs, char *const *args, size_t count);
 void ls(const FileSystem *fs, const char *path, bool long_listing);
+void complete(const FileSystem *fs, const char *prefix);
 bool cd(FileSystem *fs, const char *path);
 void pwd(const FileSystem *fs);
 bool wrts(const FileSystem *fs, const char *output_file);
-void help();
+bool wrts_compact(const FileSystem *fs, const char *output_file);
+bool bgsave(FileSystem *fs, const char *output_file, bool compact);
+void lastsave(FileSystem *fs);
+bool import_dir(FileSystem *fs, const char *host_dir, const char *target);
+// Consultas por fecha de creación (usan el índice global, sin recorrer el árbol)
+bool parse_time(const char *text, time_t *result);
+void find_by_time(const FileSystem *fs, time_t newer_than, time_t older_than);
+void recent(const FileSystem *fs, size_t count);
+// Búsqueda por nombre en todo el árbol (usa el índice global de nombres)
+void locate(const FileSystem *fs, const char *name);
+void locate_stats(const FileSystem *fs);
+void compact(FileSystem *fs);
+void memstats(const FileSystem *fs);
+void help(const FileSystem *fs);
 void exit_filesystem(FileSystem *fs);
 
 #endif
\ No newline at end of file
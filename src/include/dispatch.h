@@ -0,0 +1,58 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include "commands.h"
+#include <stdint.h>
+
+#define MAX_CMD 1024
+#define MAX_ARGS (MAX_CMD / 2)
+
+// Comandos que entiende el intérprete
+typedef enum {
+    CMD_EMPTY,
+    CMD_TOUCH,
+    CMD_RM,
+    CMD_MKDIR,
+    CMD_RMDIR,
+    CMD_LS,
+    CMD_COMPLETE,
+    CMD_CD,
+    CMD_PWD,
+    CMD_WRTS,
+    CMD_BGSAVE,
+    CMD_LASTSAVE,
+    CMD_IMPORT,
+    CMD_FIND,
+    CMD_RECENT,
+    CMD_LOCATE,
+    CMD_COMPACT,
+    CMD_DEFRAG,
+    CMD_MEMSTATS,
+    CMD_HELP,
+    CMD_EXIT,
+    CMD_UNKNOWN
+} CommandId;
+
+// Línea de comando ya tokenizada. Las palabras (incluido el nombre del
+// comando) van seguidas en 'text', cada una terminada en '\0'.
+typedef struct {
+    uint8_t id;
+    uint16_t argc;
+    uint16_t length;   // Bytes usados de 'text'
+    char text[MAX_CMD];
+} CommandRecord;
+
+// Resultado de ejecutar un comando
+typedef enum {
+    RESULT_OK,
+    RESULT_ERROR,
+    RESULT_EXIT
+} CommandResult;
+
+// Tokeniza una línea (sin el salto de línea) separando por espacios
+void parse_command(const char *line, CommandRecord *record);
+
+// Ejecuta un comando sobre 'fs'. La salida va a fs->out.
+CommandResult execute_command(FileSystem *fs, const CommandRecord *record);
+
+#endif
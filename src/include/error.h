@@ -0,0 +1,14 @@
+#ifndef ERROR_H
+#define ERROR_H
+
+#include <stdio.h>
+
+// Flujo de los mensajes de error de los módulos que no reciben el FileSystem
+// (árbol, índices, expansión e importación). Es stderr salvo en el modo en
+// tubería, que lo cambia para que los mensajes salgan en orden con la salida.
+void set_error_stream(FILE *err);
+FILE* error_stream();
+// Igual que perror, pero escribe en error_stream()
+void report_errno(const char *message);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef EXPAND_H
+#define EXPAND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Lista dinámica de palabras producida por la expansión de llaves
+typedef struct {
+    char **words;
+    size_t count;
+    size_t capacity;
+    bool overflow;   // La expansión superó MAX_EXPANSION palabras
+} WordList;
+
+// Expande las llaves de 'word' al estilo de bash y agrega el resultado a 'list':
+//   {a,b,c}  -> a b c
+//   {1..10}  -> 1 2 ... 10 (admite ceros a la izquierda y rangos descendentes)
+//   {a..z}   -> a b ... z
+// Una palabra sin llaves válidas se agrega tal cual. Devuelve false si falta memoria
+// o si la expansión supera MAX_EXPANSION palabras (en ese caso marca 'overflow'
+// y el mensaje queda a cargo de quien llama).
+bool expand_braces(const char *word, WordList *list);
+void free_word_list(WordList *list);
+
+// Indica si la palabra contiene llaves o comodines (*, ?, [) y requiere expansión
+bool needs_expansion(const char *word);
+bool has_glob(const char *word);
+
+#define MAX_EXPANSION 10000000
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef IMPORT_H
+#define IMPORT_H
+
+#include "node.h"
+
+// Resultado de una importación
+typedef struct {
+    long nodes;      // Nodos creados
+    long errors;     // Entradas o directorios que no se pudieron leer
+    int threads;     // Hilos usados
+} ImportStats;
+
+// Importa el contenido del directorio real 'host_dir' como hijos de 'target'.
+// Recorre el directorio con varios hilos (una tarea por directorio).
+// 'host_dir' puede ser un enlace simbólico; los enlaces que contiene se
+// importan como archivos y no se siguen. Devuelve false si 'host_dir' no se
+// pudo abrir.
+bool import_host_directory(Node *target, const char *host_dir, ImportStats *stats);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include "node.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Índice invertido global: nombre -> lista de nodos con ese nombre, y además
+// (padre, nombre) -> nodos, para buscar un hijo sin recorrer los hermanos.
+// Ambas son tablas con direccionamiento abierto que guardan el hash en cada
+// casillero, así que crecer no recorre las entradas.
+// create_node agrega cada nodo y su liberación lo quita; es seguro usarlo
+// desde varios hilos (import crea nodos en paralelo).
+typedef struct NameEntry NameEntry;
+
+// Función que recibe cada nodo de una consulta; devuelve false para detenerla
+typedef bool (*NameVisitor)(Node *node, void *ctx);
+
+// Memoria usada por el índice, medida con malloc_usable_size
+typedef struct {
+    size_t names;        // Nombres distintos
+    size_t entries;      // Nodos indexados
+    size_t table_bytes;       // Tabla de nombres
+    size_t child_table_bytes; // Tabla (padre, nombre)
+    size_t entry_bytes;       // Un registro por nodo
+} NameIndexStats;
+
+// 'name' debe ser el nombre del propio nodo: el índice no lo copia. El nodo
+// queda indexado bajo su padre actual (get_parent).
+// Se debe quitar la entrada antes de liberar el nodo.
+NameEntry* name_index_insert(const char *name, Node *node);
+// Inserta varios nodos (con su nombre y su padre actuales) tomando el bloqueo
+// una sola vez. Deja en entries[i] la entrada de nodes[i], o NULL si faltó
+// memoria. Con 'skip_existing' tampoco inserta (y deja NULL) los nodos cuyo
+// padre ya tiene un hijo indexado con ese nombre y tipo, aunque sea uno
+// anterior del mismo lote.
+void name_index_insert_batch(Node *const *nodes, size_t count, NameEntry **entries, bool skip_existing);
+// Agranda las tablas de una vez para 'count' nodos más, así un lote grande no
+// las vuelve a armar varias veces mientras se inserta
+void name_index_reserve(size_t count);
+void name_index_remove(NameEntry *entry);
+// Quita varias entradas (las NULL se ignoran) tomando el bloqueo una sola vez.
+// Los nodos todavía deben ser válidos.
+void name_index_remove_batch(NameEntry *const *entries, size_t count);
+// Quita y libera todas las entradas. Los nodos que las tenían ya no deben
+// usarlas (free_filesystem_tree libera así el árbol completo).
+void name_index_clear();
+// El nodo de la entrada se copió a 'node' (compact_tree). Toma el padre de 'node'.
+void name_index_relocate(NameEntry *entry, Node *node);
+// El nodo de 'entry' pasó a colgar de 'parent'
+void name_index_reparent(NameEntry *entry, const Node *parent);
+
+// Hijo de 'parent' llamado 'name' y del tipo dado, o NULL. Cuesta O(1)
+// esperado: no depende de cuántos hijos tenga 'parent' ni de cuántos nodos
+// del árbol se llamen igual.
+Node* name_index_find_child(const Node *parent, const char *name, NodeType type);
+
+// Visita todos los nodos llamados 'name', en orden de creación.
+// Devuelve la cantidad visitada.
+size_t name_index_lookup(const char *name, NameVisitor visit, void *ctx);
+void name_index_stats(NameIndexStats *stats);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef NAME_SET_H
+#define NAME_SET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Conjunto de nombres (tabla hash con direccionamiento abierto).
+// Guarda los punteros tal cual: las cadenas deben vivir más que el conjunto.
+typedef struct NameSet NameSet;
+
+NameSet* name_set_create(size_t expected);
+// Devuelve false si el nombre ya estaba en el conjunto
+bool name_set_insert(NameSet *set, const char *name);
+bool name_set_contains(const NameSet *set, const char *name);
+void name_set_free(NameSet *set);
+
+#endif
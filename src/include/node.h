@@ -5,6 +5,12 @@
 #include <stdio.h>
 #include <time.h>
 
+// Primera línea de los archivos escritos con 'wrts --compact'
+#define COMPACT_HEADER "#simfs-compact 1"
+
+// Longitud máxima de un camino absoluto
+#define MAX_PATH_LEN 1024
+
 // Definición opaca de la estructura nodeStruct
 typedef struct nodeStruct Node;
 
@@ -17,12 +23,52 @@ typedef enum {
 Node* find_node(Node *root, const char *name, NodeType type);
 
 time_t get_creation_time(const Node *node);
+void set_creation_time(Node *node, time_t creation_time);
 
 // Funciones para manipulación de nodos
 Node* create_node(const char *name, NodeType type, Node *parent);
-void add_child(Node *parent, Node *child);
+
+// Lote de nodos nuevos que se agregan juntos a los índices de fechas y de
+// nombres: cada índice se bloquea una vez por lote y no una vez por nodo.
+// Se inicializa con {.count = 0}.
+#define NODE_BATCH_SIZE 256
+typedef struct {
+    Node *nodes[NODE_BATCH_SIZE];
+    size_t count;
+} NodeBatch;
+
+// Crea un nodo con la fecha dada, que se indexa al vaciar el lote (si el lote
+// está lleno se vacía antes). Hasta entonces no lo encuentran has_child_named,
+// locate ni find, y no se puede liberar.
+Node* batch_create_node(NodeBatch *batch, const char *name, NodeType type, Node *parent, time_t creation_time);
+// Indexa los nodos pendientes del lote
+void batch_flush(NodeBatch *batch);
+// Devuelve false (sin enlazar a 'child') si 'parent' tiene los hijos
+// desalojados y no se pudieron recargar
+bool add_child(Node *parent, Node *child);
+// Enlaza 'child' justo después de 'prev' (último hijo conocido de 'parent').
+// Si 'prev' es NULL se comporta como add_child.
+bool add_child_after(Node *parent, Node *prev, Node *child);
 void remove_node(Node *node);
+
+// Inserción en lote: crea en 'parent' un hijo de tipo 'type' por cada nombre
+// que no exista ya entre sus hijos de ese tipo, en una sola pasada.
+// Devuelve la cantidad de nodos creados.
+size_t add_children(Node *parent, const char *const *names, size_t count, NodeType type);
+// Elimina en una sola pasada los hijos de 'parent' de tipo 'type' sin
+// descendientes cuyo nombre cumpla 'match'. Devuelve la cantidad eliminada.
+size_t remove_children_if(Node *parent, NodeType type, bool (*match)(const char *name, void *ctx), void *ctx);
 void free_tree(Node *root);
+// Libera el árbol de todo el sistema de archivos. Si tiene a todos los nodos
+// de los índices, los vacía de una vez en lugar de quitarlos uno por uno.
+void free_filesystem_tree(Node *root);
+// Copia el árbol a un único bloque de memoria en preorden, con los hijos de
+// cada directorio contiguos, y libera los nodos viejos. Devuelve la nueva
+// raíz y actualiza '*current' si apuntaba a un nodo del árbol.
+Node* compact_tree(Node *root, Node **current);
+// Recorre el árbol en preorden leyendo cada nombre y devuelve cuántos nodos
+// visitó. Se usa para medir el costo de un recorrido.
+size_t traverse_tree(const Node *root);
 
 // Funciones para obtener información del nodo
 const char* get_node_name(const Node *node);
@@ -31,11 +77,72 @@ Node* get_parent(const Node *node);
 Node* get_first_child(const Node *node);
 Node* get_next_sibling(const Node *node);
 
+// Escribe en 'buffer' el camino absoluto del nodo. Devuelve su largo; si no
+// cabe en 'size' deja el buffer vacío (igual que snprintf, devuelve el largo necesario).
+size_t get_node_path(const Node *node, char *buffer, size_t size);
+
+// Hijo de 'parent' llamado 'name' del tipo dado, o NULL, en O(1) esperado
+// (usa la tabla (padre, nombre) del índice de nombres)
+Node* find_child(const Node *parent, const char *name, NodeType type);
+// Indica si 'parent' tiene un hijo llamado 'name' del tipo dado
+bool has_child_named(const Node *parent, const char *name, NodeType type);
+
+// Visita en orden lexicográfico los hijos de 'parent' cuyo nombre empieza con
+// 'prefix' ('visit' devuelve false para detener la consulta). En directorios
+// grandes usa un árbol radix que se crea en la primera consulta y luego se
+// mantiene al agregar o quitar hijos. Devuelve la cantidad visitada.
+size_t find_children_with_prefix(Node *parent, const char *prefix, bool (*visit)(Node *node, void *ctx), void *ctx);
+
 // Función auxiliar que busca entre los hijos inmediatos de 'parent'
 Node* find_immediate_child(Node *parent, const char *name);
 // Función auxiliar que recorre el árbol en preorden y escribe cada nodo.
-void write_preorder(FILE *file, const Node *node, const char *parent_path);
+// Las dos escrituras devuelven false si no se pudo recargar un directorio desalojado.
+bool write_preorder(FILE *file, const Node *node, const char *parent_path);
+// Escribe el árbol en formato compacto (codificación por prefijos, ver wrts --compact).
+bool write_preorder_compact(FILE *file, const Node *root);
+// Carga bajo 'root' un árbol escrito con write_preorder_compact (empezando por
+// COMPACT_HEADER). Devuelve false si el archivo no tiene ese formato.
+bool read_preorder_compact(FILE *file, Node *root);
     
+// Desalojo de subárboles fríos (--mem-limit). Los hijos de los directorios
+// menos usados se escriben en un archivo temporal y se cargan de nuevo al
+// accederlos; el resto de las funciones de este archivo lo hace solo.
+typedef struct {
+    size_t limit;            // 0 = sin límite
+    size_t node_bytes;       // Nodos y nombres residentes
+    size_t time_index_bytes;
+    size_t name_index_bytes;
+    size_t stub_bytes;
+    size_t spilled_dirs;     // Directorios con sus hijos en disco
+    size_t spilled_nodes;
+    size_t spill_file_bytes;
+    size_t spills;           // Desalojos realizados
+    size_t faults;           // Directorios recargados
+} MemoryStats;
+
+void set_memory_limit(size_t bytes);
+// Memoria que usan los nodos residentes y los índices globales
+size_t memory_usage();
+void get_memory_stats(MemoryStats *stats);
+// Registra un acceso al nodo (cd, ls, búsqueda de un hijo)
+void mark_accessed(Node *node);
+// Si se superó el límite, desaloja los subárboles menos usados hasta bajar al
+// 90%. Nunca desaloja la raíz ni el camino hasta 'current'. Devuelve los nodos desalojados.
+size_t enforce_memory_limit(Node *root, Node *current);
+// Los índices globales solo conocen los nodos residentes. Antes de consultarlos
+// se recargan los subárboles desalojados que pueden tener nodos llamados 'name'
+// (según el filtro de cada stub) o creados entre 'from' y 'to'; el resto sigue
+// en disco. Devuelven cuántos directorios recargaron.
+size_t load_spilled_named(const char *name);
+size_t load_spilled_in_range(time_t from, time_t to);
+// Un hijo de bgsave lee los bloques del archivo de desalojo que había al hacer
+// el fork; mientras haya alguno vivo (pin sin su unpin) el archivo no se trunca.
+void spill_file_pin();
+void spill_file_unpin();
+// Recarga los hijos de 'node' si están desalojados. Devuelve false si no se
+// pudieron leer del archivo (siguen desalojados o quedaron incompletos).
+bool load_children(Node *node);
+
 // Función para imprimir la estructura del árbol (para depuración) esto se puede borrar no lo he implementado
 void print_tree(const Node *root, int depth);
 
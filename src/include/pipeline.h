@@ -0,0 +1,13 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "commands.h"
+
+// Ejecuta el intérprete en tres etapas: un hilo lee y tokeniza la entrada,
+// el hilo actual aplica los comandos y otro hilo escribe la salida. Las etapas
+// se comunican con colas circulares sin bloqueos de un productor y un consumidor.
+// La salida es idéntica a la del intérprete secuencial, con los mensajes de
+// error de los comandos en el mismo lugar.
+void run_pipeline(FileSystem *fs, FILE *input);
+
+#endif
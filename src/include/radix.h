@@ -0,0 +1,28 @@
+#ifndef RADIX_H
+#define RADIX_H
+
+#include "node.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Árbol radix comprimido sobre los nombres de los hijos de un directorio.
+// Cada arista guarda un tramo del nombre; los nodos con el mismo nombre (un
+// archivo y un directorio) comparten la hoja. Copia las etiquetas, así que
+// los nombres de los nodos pueden moverse (compact_tree usa radix_relocate).
+typedef struct RadixTree RadixTree;
+
+// Función que recibe cada nodo de una consulta; devuelve false para detenerla
+typedef bool (*RadixVisitor)(Node *node, void *ctx);
+
+RadixTree* radix_create();
+bool radix_insert(RadixTree *tree, const char *name, Node *node);
+void radix_remove(RadixTree *tree, const char *name, const Node *node);
+// El nodo 'old' llamado 'name' se movió a 'node'
+void radix_relocate(RadixTree *tree, const char *name, const Node *old, Node *node);
+
+// Visita en orden lexicográfico los nodos cuyo nombre empieza con 'prefix'.
+// Cuesta O(largo del prefijo + resultados). Devuelve la cantidad visitada.
+size_t radix_prefix(const RadixTree *tree, const char *prefix, RadixVisitor visit, void *ctx);
+void radix_free(RadixTree *tree);
+
+#endif
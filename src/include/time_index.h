@@ -0,0 +1,39 @@
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+
+#include "node.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+// Índice global ordenado por fecha de creación (lista de saltos).
+// create_node agrega cada nodo y su liberación lo quita; es seguro usarlo
+// desde varios hilos (import crea nodos en paralelo).
+typedef struct TimeEntry TimeEntry;
+
+// Función que recibe cada nodo de una consulta; devuelve false para detenerla
+typedef bool (*TimeVisitor)(Node *node, void *ctx);
+
+TimeEntry* time_index_insert(time_t creation_time, Node *node);
+// Inserta varios nodos (con su fecha de creación actual) tomando el bloqueo
+// una sola vez. Deja en entries[i] la entrada de nodes[i], o NULL si faltó memoria.
+void time_index_insert_batch(Node *const *nodes, size_t count, TimeEntry **entries);
+void time_index_remove(TimeEntry *entry);
+// Quita varias entradas (las NULL se ignoran) tomando el bloqueo una sola vez
+void time_index_remove_batch(TimeEntry *const *entries, size_t count);
+// Quita y libera todas las entradas. Los nodos que las tenían ya no deben
+// usarlas (free_filesystem_tree libera así el árbol completo).
+void time_index_clear();
+// El nodo de la entrada se movió a otra dirección (compact_tree)
+void time_index_relocate(TimeEntry *entry, Node *node);
+
+// Visita en orden ascendente los nodos con from <= fecha <= to.
+// Cuesta O(log n + resultados). Devuelve la cantidad visitada.
+size_t time_index_range(time_t from, time_t to, TimeVisitor visit, void *ctx);
+// Visita los 'count' nodos más recientes, del más nuevo al más viejo
+size_t time_index_recent(size_t count, TimeVisitor visit, void *ctx);
+size_t time_index_size();
+// Bytes ocupados por las entradas del índice
+size_t time_index_memory();
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "dispatch.h"
+#include <stdbool.h>
+
+// Primeros bytes de un archivo de traza (--record)
+#define TRACE_MAGIC "SIMFSTR1"
+
+// Grabación de los comandos que ejecuta el intérprete. Cada registro guarda
+// el momento en que llegó el comando, cuánto tardó, su resultado y el largo y
+// hash de su salida, para poder reproducirlos y comparar después.
+typedef struct TraceWriter TraceWriter;
+
+TraceWriter* trace_open(const char *path);
+// Ejecuta el comando igual que execute_command y lo agrega a la traza
+CommandResult trace_execute(TraceWriter *trace, FileSystem *fs, const CommandRecord *record);
+// Cierra el archivo; devuelve false si hubo errores al escribirlo
+bool trace_close(TraceWriter *trace);
+
+// Reproduce una traza sobre 'fs' (lo más rápido posible, o respetando los
+// tiempos originales si 'paced') y muestra el rendimiento, los percentiles de
+// latencia por comando y los resultados distintos a los grabados.
+bool replay_trace(FileSystem *fs, const char *path, bool paced);
+
+#endif
@@ -1,13 +1,18 @@
+#include <getopt.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <termios.h>
 #include "include/commands.h"
-
-#define MAX_CMD 1024
+#include "include/dispatch.h"
+#include "include/pipeline.h"
+#include "include/trace.h"
 
 // Función para cargar el sistema de archivos a partir de un archivo de entrada.
 // Se asume que cada línea tiene el formato: <camino> <espacio o tab> <tipo>
 // Ejemplo de línea: /home/lear/a.pdf F
+// Si la primera línea es COMPACT_HEADER se usa el formato de 'wrts --compact'.
 void load_filesystem_from_file(FileSystem *fs, const char *filename)
 {
     FILE *fp = fopen(filename, "r");
@@ -18,8 +23,20 @@ void load_filesystem_from_file(FileSystem *fs, const char *filename)
     }
 
     char line[MAX_CMD];
+    bool first_line = true;
     while (fgets(line, sizeof(line), fp))
     {
+        if (first_line)
+        {
+            first_line = false;
+            if (strncmp(line, COMPACT_HEADER, strlen(COMPACT_HEADER)) == 0)
+            {
+                rewind(fp);
+                read_preorder_compact(fp, fs->root);
+                break;
+            }
+        }
+
         // Eliminar el salto de línea
         line[strcspn(line, "\n")] = '\0';
         if (strlen(line) == 0)
@@ -79,9 +96,122 @@ void load_filesystem_from_file(FileSystem *fs, const char *filename)
     fclose(fp);
 }
 
+// Intérprete secuencial: lee, ejecuta e imprime una línea a la vez. Si
+// 'trace' no es NULL cada comando se graba en la traza (--record).
+void run_repl(FileSystem *fs, FILE *input_file, TraceWriter *trace)
+{
+    char input[MAX_CMD];
+    CommandRecord record;
+    // En una terminal el indicador se muestra antes de ejecutar el comando, así
+    // sus mensajes de error quedan después de él, como en el modo en tubería
+    // (tcgetattr equivale a isatty; unistd.h choca con mkdir y rmdir)
+    struct termios term;
+    bool interactive = tcgetattr(fileno(fs->out), &term) == 0;
+    fprintf(fs->out, "> ");
+    if (interactive)
+        fflush(fs->out);
+    while (fgets(input, sizeof(input), input_file))
+    {
+        // Eliminar el salto de línea
+        input[strcspn(input, "\n")] = '\0';
+
+        parse_command(input, &record);
+        CommandResult result = trace ? trace_execute(trace, fs, &record) : execute_command(fs, &record);
+        if (result == RESULT_EXIT)
+            break;
+
+        fprintf(fs->out, "> ");
+        if (interactive)
+            fflush(fs->out);
+    }
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "Uso: %s [--pipeline | --record <traza> | --replay <traza> [--paced]] [--mem-limit <bytes>[K|M|G]] [archivo_con_unix_fs]\n", program);
+}
+
+// Convierte un tamaño como "512K" o "64M" a bytes
+static bool parse_size(const char *text, size_t *bytes)
+{
+    char *end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text || text[0] == '-')
+        return false;
+
+    unsigned shift = 0;
+    switch (*end)
+    {
+    case 'K': case 'k': shift = 10; end++; break;
+    case 'M': case 'm': shift = 20; end++; break;
+    case 'G': case 'g': shift = 30; end++; break;
+    }
+    if (*end != '\0' || value == 0 || value > (SIZE_MAX >> shift))
+        return false;
+
+    *bytes = (size_t)value << shift;
+    return true;
+}
+
 //Funcion principal del programa
 int main(int argc, char *argv[])
 {
+    static const struct option options[] = {
+        {"pipeline", no_argument, NULL, 'p'},
+        {"mem-limit", required_argument, NULL, 'm'},
+        {"record", required_argument, NULL, 'r'},
+        {"replay", required_argument, NULL, 'R'},
+        {"paced", no_argument, NULL, 'P'},
+        {NULL, 0, NULL, 0}
+    };
+
+    bool pipeline = false;
+    const char *record_file = NULL;
+    const char *replay_file = NULL;
+    bool paced = false;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            pipeline = true;
+            break;
+        case 'm':
+        {
+            size_t limit;
+            if (!parse_size(optarg, &limit))
+            {
+                fprintf(stderr, "Error: límite de memoria inválido '%s'.\n", optarg);
+                return 1;
+            }
+            set_memory_limit(limit);
+            break;
+        }
+        case 'r':
+            record_file = optarg;
+            break;
+        case 'R':
+            replay_file = optarg;
+            break;
+        case 'P':
+            paced = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // A lo sumo un argumento posicional: el archivo de sistema de archivos.
+    // Solo el intérprete secuencial graba, y una reproducción no lee comandos.
+    if (argc - optind > 1 || (pipeline + (record_file != NULL) + (replay_file != NULL)) > 1 ||
+        (paced && !replay_file))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
     FileSystem *fs = init_filesystem();
     if (!fs)
     {
@@ -90,150 +220,42 @@ int main(int argc, char *argv[])
     }
 
     // Si se pasó un argumento (archivo de sistema de archivos), cargarlo
-    if (argc == 2)
+    if (optind < argc)
     {
-        load_filesystem_from_file(fs, argv[1]);
-    }
-    else if (argc > 2)
-    {
-        fprintf(stderr, "Uso: %s [archivo_con_unix_fs]\n", argv[0]);
-        exit_filesystem(fs);
-        return 1;
+        load_filesystem_from_file(fs, argv[optind]);
     }
 
     // Ubicar al usuario en la raíz
     fs->current_dir = fs->root;
+    enforce_memory_limit(fs->root, fs->current_dir);
 
-    char input[MAX_CMD];
-    printf("> ");
-    while (fgets(input, sizeof(input), stdin))
+    int status = 0;
+    if (pipeline)
     {
-        // Eliminar el salto de línea
-        input[strcspn(input, "\n")] = '\0';
-        if (strlen(input) == 0)
-        {
-            printf("> ");
-            continue;
-        }
-
-        // Tokenizar la entrada
-        char *command = strtok(input, " ");
-        if (!command)
-        {
-            printf("> ");
-            continue;
-        }
-
-        // Despacho de comandos
-        if (strcmp(command, "touch") == 0)
-        {
-            char *arg = strtok(NULL, " ");
-            if (!arg)
-            {
-                printf("Uso: touch <nombre_archivo>\n");
-            }
-            else
-            {
-                if (!touch(fs, arg))
-                {
-                    // El error ya se imprime dentro de la función
-                }
-            }
-        }
-        else if (strcmp(command, "rm") == 0)
-        {
-            char *arg = strtok(NULL, " ");
-            if (!arg)
-            {
-                printf("Uso: rm <nombre_archivo>\n");
-            }
-            else
-            {
-                rm(fs, arg);
-            }
-        }
-        else if (strcmp(command, "mkdir") == 0)
-        {
-            char *arg = strtok(NULL, " ");
-            if (!arg)
-            {
-                printf("Uso: mkdir <nombre_directorio>\n");
-            }
-            else
-            {
-                mkdir(fs, arg);
-            }
-        }
-        else if (strcmp(command, "rmdir") == 0)
-        {
-            char *arg = strtok(NULL, " ");
-            if (!arg)
-            {
-                printf("Uso: rmdir <nombre_directorio>\n");
-            }
-            else
-            {
-                rmdir(fs, arg);
-            }
-        }
-        else if (strcmp(command, "ls") == 0)
-        {
-            char *arg = strtok(NULL, " ");
-            bool long_listing = false;
-            if (arg && strcmp(arg, "-l") == 0)
-            {
-                long_listing = true;
-                arg = strtok(NULL, " ");
-            }
-            ls(fs, arg, long_listing);
-        }
-        else if (strcmp(command, "cd") == 0)
-        {
-            char *arg = strtok(NULL, " ");
-            if (!arg)
-            {
-                printf("Uso: cd <nombre_directorio>\n");
-            }
-            else
-            {
-                cd(fs, arg);
-            }
-        }
-        else if (strcmp(command, "pwd") == 0)
-        {
-            pwd(fs);
-        }
-        else if (strcmp(command, "wrts") == 0)
-        {
-            char *arg = strtok(NULL, " ");
-            if (!arg)
-            {
-                printf("Uso: wrts <nombre_del_archivo>\n");
-            }
-            else
-            {
-                if (!wrts(fs, arg))
-                {
-                    printf("Error al escribir el sistema de archivos.\n");
-                }
-            }
-        }
-        else if (strcmp(command, "help") == 0)
-        {
-            help();
-        }
-        else if (strcmp(command, "exit") == 0)
+        run_pipeline(fs, stdin);
+    }
+    else if (replay_file)
+    {
+        status = replay_trace(fs, replay_file, paced) ? 0 : 1;
+    }
+    else if (record_file)
+    {
+        TraceWriter *trace = trace_open(record_file);
+        if (trace)
         {
-            break;
+            run_repl(fs, stdin, trace);
+            status = trace_close(trace) ? 0 : 1;
         }
         else
         {
-            printf("Comando desconocido. Escriba 'help' para ver los comandos disponibles.\n");
+            status = 1;
         }
-
-        printf("> ");
+    }
+    else
+    {
+        run_repl(fs, stdin, NULL);
     }
 
     exit_filesystem(fs);
-    return 0;
+    return status;
 }
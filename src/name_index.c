@@ -0,0 +1,445 @@
+#include "include/name_index.h"
+#include "include/error.h"
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Posiciones que se piden a memoria por adelantado al recorrer muchas entradas
+#define PREFETCH_DISTANCE 8
+
+// Un registro por nodo. Los nodos que comparten un nombre forman una lista
+// circular en orden de creación; la tabla de nombres apunta a la primera.
+struct NameEntry
+{
+    Node *node;
+    NameEntry *prev;
+    NameEntry *next;
+    const Node *parent; // Padre con el que está en la tabla de hijos
+    uint64_t hash;      // Hash del nombre
+};
+
+// Casillero de una tabla con direccionamiento abierto (sondeo lineal). Se
+// guarda el hash junto al puntero, así al sondear casi nunca hace falta leer
+// una entrada ajena y agrandar la tabla no toca las entradas.
+typedef struct
+{
+    uint64_t hash;
+    NameEntry *entry; // NULL = libre
+} Slot;
+
+typedef struct
+{
+    Slot *slots;
+    size_t capacity; // Siempre potencia de dos; factor de carga máximo de 1/2
+    size_t used;
+} Table;
+
+static struct
+{
+    pthread_mutex_t lock;
+    Table names;    // Nombre -> primera entrada con ese nombre
+    Table children; // (padre, nombre) -> entrada
+    size_t entries;
+    size_t entry_bytes;
+} index_state = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+// Hash FNV-1a de 64 bits (el mismo de name_set.c)
+static uint64_t hash_name(const char *name)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+    {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Combina el hash del nombre con la dirección del padre
+static uint64_t hash_child(const Node *parent, uint64_t name_hash)
+{
+    uint64_t hash = name_hash ^ ((uint64_t)(uintptr_t)parent * 0x9E3779B97F4A7C15ULL);
+    return hash ^ (hash >> 29);
+}
+
+// Ocupa el primer casillero libre a partir de la posición del hash
+static void table_put(Table *table, uint64_t hash, NameEntry *entry)
+{
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    while (table->slots[i].entry)
+        i = (i + 1) & mask;
+    table->slots[i] = (Slot){hash, entry};
+    table->used++;
+}
+
+// Posición de 'entry' en la tabla, o SIZE_MAX si no está
+static size_t table_find(const Table *table, uint64_t hash, const NameEntry *entry)
+{
+    size_t mask = table->capacity - 1;
+    for (size_t i = hash & mask; table->slots[i].entry; i = (i + 1) & mask)
+    {
+        if (table->slots[i].entry == entry)
+            return i;
+    }
+    return SIZE_MAX;
+}
+
+// Libera un casillero corriendo hacia atrás los que quedarían fuera de su
+// secuencia de sondeo, así no hacen falta marcas de borrado
+static void table_delete(Table *table, size_t pos)
+{
+    size_t mask = table->capacity - 1;
+    size_t hole = pos;
+    for (size_t i = (pos + 1) & mask; table->slots[i].entry; i = (i + 1) & mask)
+    {
+        size_t home = table->slots[i].hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            table->slots[hole] = table->slots[i];
+            hole = i;
+        }
+    }
+    table->slots[hole].entry = NULL;
+    table->used--;
+}
+
+// Agranda la tabla hasta que entren 'count' casilleros más. Devuelve false
+// si no hay memoria para la tabla mínima.
+static bool table_reserve(Table *table, size_t count)
+{
+    if ((table->used + count) * 2 <= table->capacity)
+        return true;
+
+    size_t capacity = table->capacity ? table->capacity : 1024;
+    while ((table->used + count) * 2 > capacity)
+        capacity *= 2;
+    Slot *slots = calloc(capacity, sizeof(Slot));
+    if (!slots)
+        return table->used + count < table->capacity; // Se sigue con la actual si entra
+
+    Table grown = {slots, capacity, 0};
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        if (table->slots[i].entry)
+            table_put(&grown, table->slots[i].hash, table->slots[i].entry);
+    }
+    free(table->slots);
+    *table = grown;
+    return true;
+}
+
+// Posición de la primera entrada llamada 'name', o del casillero libre donde iría
+static size_t find_name(uint64_t hash, const char *name)
+{
+    const Table *table = &index_state.names;
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    while (table->slots[i].entry &&
+           (table->slots[i].hash != hash || strcmp(get_node_name(table->slots[i].entry->node), name) != 0))
+        i = (i + 1) & mask;
+    return i;
+}
+
+static bool reserve(size_t count)
+{
+    return table_reserve(&index_state.names, count) && table_reserve(&index_state.children, count);
+}
+
+// Entrada del hijo de 'parent' llamado 'name' y del tipo dado, o NULL. 'hash'
+// es el de hash_child. Debe llamarse con el bloqueo tomado.
+static NameEntry *lookup_child(const Node *parent, const char *name, NodeType type, uint64_t hash)
+{
+    const Table *table = &index_state.children;
+    if (!table->slots)
+        return NULL;
+
+    size_t mask = table->capacity - 1;
+    for (size_t i = hash & mask; table->slots[i].entry; i = (i + 1) & mask)
+    {
+        NameEntry *entry = table->slots[i].entry;
+        if (table->slots[i].hash == hash && entry->parent == parent && get_node_type(entry->node) == type &&
+            strcmp(get_node_name(entry->node), name) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+// Agrega la entrada al final de la lista de su nombre y a la tabla de hijos.
+// Debe llamarse con el bloqueo tomado y lugar reservado en las tablas.
+static void link_entry(NameEntry *entry, const char *name, uint64_t hash)
+{
+    entry->hash = hash;
+    size_t pos = find_name(hash, name);
+    NameEntry *first = index_state.names.slots[pos].entry;
+    if (first)
+    {
+        entry->prev = first->prev;
+        entry->next = first;
+        first->prev->next = entry;
+        first->prev = entry;
+    }
+    else
+    {
+        entry->prev = entry;
+        entry->next = entry;
+        index_state.names.slots[pos] = (Slot){hash, entry};
+        index_state.names.used++;
+    }
+
+    entry->parent = get_parent(entry->node);
+    table_put(&index_state.children, hash_child(entry->parent, hash), entry);
+
+    index_state.entries++;
+    index_state.entry_bytes += malloc_usable_size(entry);
+}
+
+NameEntry *name_index_insert(const char *name, Node *node)
+{
+    NameEntry *entry = malloc(sizeof(NameEntry));
+    if (!entry)
+    {
+        report_errno("Error al asignar memoria para el índice de nombres");
+        return NULL;
+    }
+    entry->node = node;
+
+    uint64_t hash = hash_name(name);
+    pthread_mutex_lock(&index_state.lock);
+    bool reserved = reserve(1);
+    if (reserved)
+        link_entry(entry, name, hash);
+    pthread_mutex_unlock(&index_state.lock);
+    if (!reserved)
+    {
+        free(entry);
+        return NULL;
+    }
+    return entry;
+}
+
+void name_index_reserve(size_t count)
+{
+    pthread_mutex_lock(&index_state.lock);
+    reserve(count);
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+// Calcula el hash del nombre del nodo y trae a la caché los casilleros que
+// va a tocar su inserción
+static uint64_t prefetch_slots(const Node *node)
+{
+    uint64_t hash = hash_name(get_node_name(node));
+    __builtin_prefetch(&index_state.names.slots[hash & (index_state.names.capacity - 1)]);
+    __builtin_prefetch(&index_state.children.slots[hash_child(get_parent(node), hash) &
+                                                    (index_state.children.capacity - 1)]);
+    return hash;
+}
+
+void name_index_insert_batch(Node *const *nodes, size_t count, NameEntry **entries, bool skip_existing)
+{
+    // Las entradas se reservan antes de tomar el bloqueo
+    for (size_t i = 0; i < count; i++)
+    {
+        entries[i] = malloc(sizeof(NameEntry));
+        if (entries[i])
+            entries[i]->node = nodes[i];
+        else
+            report_errno("Error al asignar memoria para el índice de nombres");
+    }
+
+    pthread_mutex_lock(&index_state.lock);
+    if (!reserve(count))
+    {
+        pthread_mutex_unlock(&index_state.lock);
+        for (size_t i = 0; i < count; i++)
+        {
+            free(entries[i]);
+            entries[i] = NULL;
+        }
+        return;
+    }
+
+    // Con las tablas ya dimensionadas, los casilleros de las próximas
+    // entradas se piden a memoria mientras se inserta la actual
+    uint64_t ahead[PREFETCH_DISTANCE];
+    for (size_t i = 0; i < count && i < PREFETCH_DISTANCE; i++)
+        ahead[i] = prefetch_slots(nodes[i]);
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t hash = ahead[i % PREFETCH_DISTANCE];
+        if (i + PREFETCH_DISTANCE < count)
+            ahead[i % PREFETCH_DISTANCE] = prefetch_slots(nodes[i + PREFETCH_DISTANCE]);
+        if (!entries[i])
+            continue;
+
+        const char *name = get_node_name(nodes[i]);
+        const Node *parent = get_parent(nodes[i]);
+        if (skip_existing && lookup_child(parent, name, get_node_type(nodes[i]), hash_child(parent, hash)))
+        {
+            free(entries[i]);
+            entries[i] = NULL;
+            continue;
+        }
+        link_entry(entries[i], name, hash);
+    }
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+// Quita la entrada de la lista de su nombre y de las dos tablas. Debe
+// llamarse con el bloqueo tomado.
+static void unlink_entry(NameEntry *entry)
+{
+    table_delete(&index_state.children,
+                 table_find(&index_state.children, hash_child(entry->parent, entry->hash), entry));
+
+    size_t pos = table_find(&index_state.names, entry->hash, entry);
+    if (entry->next == entry)
+    {
+        // Último nodo con este nombre
+        table_delete(&index_state.names, pos);
+    }
+    else
+    {
+        entry->prev->next = entry->next;
+        entry->next->prev = entry->prev;
+        // Si era la primera de la lista, la tabla pasa a apuntar a la siguiente
+        if (pos != SIZE_MAX)
+            index_state.names.slots[pos].entry = entry->next;
+    }
+
+    index_state.entries--;
+    index_state.entry_bytes -= malloc_usable_size(entry);
+}
+
+void name_index_remove(NameEntry *entry)
+{
+    name_index_remove_batch(&entry, 1);
+}
+
+void name_index_remove_batch(NameEntry *const *entries, size_t count)
+{
+    pthread_mutex_lock(&index_state.lock);
+    for (size_t i = 0; i < count; i++)
+    {
+        // Igual que al insertar, se adelanta la lectura de los casilleros de
+        // las próximas entradas
+        const NameEntry *ahead = i + PREFETCH_DISTANCE < count ? entries[i + PREFETCH_DISTANCE] : NULL;
+        if (ahead)
+        {
+            __builtin_prefetch(&index_state.names.slots[ahead->hash & (index_state.names.capacity - 1)]);
+            __builtin_prefetch(&index_state.children.slots[hash_child(ahead->parent, ahead->hash) &
+                                                            (index_state.children.capacity - 1)]);
+        }
+        if (entries[i])
+            unlink_entry(entries[i]);
+    }
+    pthread_mutex_unlock(&index_state.lock);
+
+    for (size_t i = 0; i < count; i++)
+        free(entries[i]);
+}
+
+void name_index_clear()
+{
+    pthread_mutex_lock(&index_state.lock);
+    // Cada entrada está en un solo casillero de la tabla de hijos
+    const Table *children = &index_state.children;
+    for (size_t i = 0; i < children->capacity; i++)
+    {
+        if (i + 2 * PREFETCH_DISTANCE < children->capacity && children->slots[i + 2 * PREFETCH_DISTANCE].entry)
+            __builtin_prefetch(children->slots[i + 2 * PREFETCH_DISTANCE].entry);
+        free(children->slots[i].entry);
+    }
+    free(index_state.names.slots);
+    free(index_state.children.slots);
+    index_state.names = (Table){NULL, 0, 0};
+    index_state.children = (Table){NULL, 0, 0};
+    index_state.entries = 0;
+    index_state.entry_bytes = 0;
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+// Cambia el padre con el que está indexada una entrada. Debe llamarse con el
+// bloqueo tomado.
+static void rekey_child(NameEntry *entry, const Node *parent)
+{
+    table_delete(&index_state.children,
+                 table_find(&index_state.children, hash_child(entry->parent, entry->hash), entry));
+    entry->parent = parent;
+    table_put(&index_state.children, hash_child(parent, entry->hash), entry);
+}
+
+void name_index_relocate(NameEntry *entry, Node *node)
+{
+    if (!entry)
+        return;
+
+    pthread_mutex_lock(&index_state.lock);
+    entry->node = node;
+    // El padre también pudo moverse
+    if (entry->parent != get_parent(node))
+        rekey_child(entry, get_parent(node));
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+void name_index_reparent(NameEntry *entry, const Node *parent)
+{
+    if (!entry)
+        return;
+
+    pthread_mutex_lock(&index_state.lock);
+    if (entry->parent != parent)
+        rekey_child(entry, parent);
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+Node *name_index_find_child(const Node *parent, const char *name, NodeType type)
+{
+    if (!name)
+        return NULL;
+
+    uint64_t hash = hash_child(parent, hash_name(name));
+    pthread_mutex_lock(&index_state.lock);
+    const NameEntry *entry = lookup_child(parent, name, type, hash);
+    Node *found = entry ? entry->node : NULL;
+    pthread_mutex_unlock(&index_state.lock);
+    return found;
+}
+
+size_t name_index_lookup(const char *name, NameVisitor visit, void *ctx)
+{
+    if (!name)
+        return 0;
+
+    size_t visited = 0;
+    pthread_mutex_lock(&index_state.lock);
+    if (index_state.names.slots)
+    {
+        NameEntry *first = index_state.names.slots[find_name(hash_name(name), name)].entry;
+        NameEntry *entry = first;
+        while (entry)
+        {
+            visited++;
+            if (!visit(entry->node, ctx))
+                break;
+            entry = entry->next == first ? NULL : entry->next;
+        }
+    }
+    pthread_mutex_unlock(&index_state.lock);
+    return visited;
+}
+
+void name_index_stats(NameIndexStats *stats)
+{
+    pthread_mutex_lock(&index_state.lock);
+    stats->names = index_state.names.used;
+    stats->entries = index_state.entries;
+    stats->table_bytes = index_state.names.slots ? malloc_usable_size(index_state.names.slots) : 0;
+    stats->child_table_bytes = index_state.children.slots ? malloc_usable_size(index_state.children.slots) : 0;
+    stats->entry_bytes = index_state.entry_bytes;
+    pthread_mutex_unlock(&index_state.lock);
+}
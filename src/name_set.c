@@ -0,0 +1,120 @@
+#include "include/name_set.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct NameSet
+{
+    const char **slots;
+    uint32_t *tags;  // Parte alta del hash de cada casillero: evita leer cadenas ajenas
+    size_t capacity; // Siempre potencia de dos
+    size_t size;
+};
+
+// Hash FNV-1a de 64 bits
+static uint64_t hash_name(const char *name)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+    {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Busca el casillero del nombre, o el casillero vacío donde debería ir. Solo
+// se comparan las cadenas cuyo casillero tiene la misma etiqueta.
+static size_t find_slot(const char **slots, const uint32_t *tags, size_t capacity, const char *name, uint64_t hash)
+{
+    size_t mask = capacity - 1;
+    size_t i = hash & mask;
+    uint32_t tag = (uint32_t)(hash >> 32);
+    while (slots[i] && (tags[i] != tag || strcmp(slots[i], name) != 0))
+        i = (i + 1) & mask;
+    return i;
+}
+
+NameSet *name_set_create(size_t expected)
+{
+    NameSet *set = malloc(sizeof(NameSet));
+    if (!set)
+        return NULL;
+
+    // Factor de carga máximo de 1/2
+    size_t capacity = 16;
+    while (capacity < expected * 2)
+        capacity *= 2;
+
+    set->slots = calloc(capacity, sizeof(const char *));
+    set->tags = malloc(capacity * sizeof(uint32_t));
+    if (!set->slots || !set->tags)
+    {
+        free(set->slots);
+        free(set->tags);
+        free(set);
+        return NULL;
+    }
+    set->capacity = capacity;
+    set->size = 0;
+    return set;
+}
+
+static bool grow(NameSet *set)
+{
+    size_t capacity = set->capacity * 2;
+    const char **slots = calloc(capacity, sizeof(const char *));
+    uint32_t *tags = malloc(capacity * sizeof(uint32_t));
+    if (!slots || !tags)
+    {
+        free(slots);
+        free(tags);
+        return false;
+    }
+
+    for (size_t i = 0; i < set->capacity; i++)
+    {
+        if (set->slots[i])
+        {
+            size_t pos = find_slot(slots, tags, capacity, set->slots[i], hash_name(set->slots[i]));
+            slots[pos] = set->slots[i];
+            tags[pos] = set->tags[i];
+        }
+    }
+    free(set->slots);
+    free(set->tags);
+    set->slots = slots;
+    set->tags = tags;
+    set->capacity = capacity;
+    return true;
+}
+
+bool name_set_insert(NameSet *set, const char *name)
+{
+    if ((set->size + 1) * 2 > set->capacity && !grow(set))
+        return false;
+
+    uint64_t hash = hash_name(name);
+    size_t i = find_slot(set->slots, set->tags, set->capacity, name, hash);
+    if (set->slots[i])
+        return false;
+
+    set->slots[i] = name;
+    set->tags[i] = (uint32_t)(hash >> 32);
+    set->size++;
+    return true;
+}
+
+bool name_set_contains(const NameSet *set, const char *name)
+{
+    return set->slots[find_slot(set->slots, set->tags, set->capacity, name, hash_name(name))] != NULL;
+}
+
+void name_set_free(NameSet *set)
+{
+    if (!set)
+        return;
+    free(set->slots);
+    free(set->tags);
+    free(set);
+}
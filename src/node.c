@@ -2,7 +2,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include "include/node.h"
+#include "include/error.h"
+#include "include/time_index.h"
+#include "include/name_index.h"
+#include "include/radix.h"
+#include <stdatomic.h>
+#include <stdint.h>
 #include <time.h>
+#include <unistd.h>
 
 // Definición de la estructura de nodo (estructura opaca)
 struct nodeStruct
@@ -13,61 +20,277 @@ struct nodeStruct
     Node *child;
     Node *sibling;
     time_t creation_time; 
+    TimeEntry *time_entry; // Entrada en el índice por fecha de creación
+    NameEntry *name_entry; // Entrada en el índice de nombres
+    struct NodeArena *arena; // Bloque de compact_tree que lo contiene (NULL si se creó con malloc)
+    uint64_t last_access;    // Momento del último acceso (contador global, no reloj)
+    struct SpillStub *stub;  // Si no es NULL, los hijos están en el archivo de desalojo
+    RadixTree *radix;        // Índice por prefijo de los hijos (se crea en la primera consulta)
 };
 
-Node *create_node(const char *name, NodeType type, Node *parent)
+// Cantidad de hijos a partir de la cual find_children_with_prefix crea el árbol radix
+#define RADIX_MIN_CHILDREN 64
+
+// Hermanos que free_tree libera juntos (cada nivel de la recursión guarda un grupo)
+#define FREE_GROUP_SIZE 64
+
+// Directorio cuyos hijos se escribieron en el archivo de desalojo
+typedef struct SpillStub
 {
-    Node *new_node = (Node *)malloc(sizeof(Node));
-    if (!new_node)
+    Node *dir;
+    off_t offset;
+    size_t length;
+    size_t nodes;        // Nodos guardados (todo el subárbol salvo el propio directorio)
+    struct SpillStub *prev;
+    struct SpillStub *next;
+    time_t min_time;       // Fechas de creación extremas del subárbol desalojado
+    time_t max_time;
+    uint32_t filter_words; // Tamaño del filtro (potencia de dos)
+    uint64_t filter[];     // Filtro de Bloom con los nombres de todo el subárbol desalojado
+} SpillStub;
+
+// Estado global del desalojo de subárboles fríos (ver enforce_memory_limit)
+static struct
+{
+    FILE *file;             // Archivo temporal, se borra solo al terminar
+    pid_t owner;            // Proceso que lo creó: un hijo de bgsave lo comparte y solo puede leerlo
+    unsigned pins;          // Hijos de bgsave vivos que pueden leer los bloques actuales
+    size_t limit;           // Límite de memoria en bytes (0 = sin límite)
+    atomic_size_t node_bytes; // Memoria de nodos y nombres residentes
+    atomic_uint_fast64_t tick;
+    SpillStub *stubs;
+    size_t stub_count;
+    size_t stub_bytes;      // Stubs y sus filtros
+    size_t spilled_nodes;
+    size_t spills;
+    size_t faults;
+} spill_state;
+
+static bool fault_in(Node *dir);
+static bool stub_may_contain(const SpillStub *stub, const char *name);
+
+// Memoria que ocupa un nodo residente (sin contar los índices)
+static size_t node_footprint(const Node *node)
+{
+    return sizeof(Node) + strlen(node->name) + 1;
+}
+
+bool load_children(Node *node)
+{
+    return !node->stub || fault_in(node);
+}
+
+// Hijos de un nodo, cargándolos del archivo de desalojo si hace falta
+static inline Node *children_of(const Node *node)
+{
+    load_children((Node *)node);
+    return node->child;
+}
+
+// Bloque contiguo creado por compact_tree: los nodos y luego sus nombres.
+// Se libera cuando no queda ningún nodo vivo dentro.
+typedef struct NodeArena
+{
+    size_t live;
+} NodeArena;
+
+// Libera la memoria de un nodo sin tocar los índices
+static void release_node(Node *node)
+{
+    if (node->arena)
     {
-        perror("Error al asignar memoria para el nodo");
-        return NULL;
+        if (--node->arena->live == 0)
+            free(node->arena);
+        return;
     }
+    free(node); // El nombre está en el mismo bloque
+}
 
-    new_node->name = strdup(name); // Copia el nombre del archivo/directorio
-    if (!new_node->name)
+// Quita un directorio desalojado de la lista de stubs
+static void unlink_stub(SpillStub *stub)
+{
+    if (stub->prev)
+        stub->prev->next = stub->next;
+    else
+        spill_state.stubs = stub->next;
+    if (stub->next)
+        stub->next->prev = stub->prev;
+    spill_state.stub_count--;
+    spill_state.stub_bytes -= sizeof(SpillStub) + stub->filter_words * sizeof(uint64_t);
+    spill_state.spilled_nodes -= stub->nodes;
+}
+
+// Libera la memoria de varios nodos (no toca a sus hijos ni hermanos). Se
+// quitan de cada índice con un solo bloqueo. 'count' <= NODE_BATCH_SIZE.
+static void destroy_nodes(Node *const *nodes, size_t count)
+{
+    TimeEntry *time_entries[NODE_BATCH_SIZE];
+    NameEntry *name_entries[NODE_BATCH_SIZE];
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++)
     {
-        perror("Error al asignar memoria para el nombre del nodo");
-        free(new_node);
+        Node *node = nodes[i];
+        if (node->stub)
+        {
+            // Su contenido en el archivo de desalojo queda descartado
+            unlink_stub(node->stub);
+            free(node->stub);
+        }
+        radix_free(node->radix);
+        bytes += node_footprint(node);
+        time_entries[i] = node->time_entry;
+        name_entries[i] = node->name_entry;
+    }
+    atomic_fetch_sub(&spill_state.node_bytes, bytes);
+    time_index_remove_batch(time_entries, count);
+    name_index_remove_batch(name_entries, count);
+
+    for (size_t i = 0; i < count; i++)
+        release_node(nodes[i]);
+}
+
+static void destroy_node(Node *node)
+{
+    destroy_nodes(&node, 1);
+}
+
+// Reserva e inicializa un nodo sin agregarlo a los índices
+static Node *alloc_node(const char *name, NodeType type, Node *parent, time_t creation_time)
+{
+    // El nombre se copia a continuación del nodo, en el mismo bloque
+    size_t name_len = strlen(name) + 1;
+    Node *new_node = (Node *)malloc(sizeof(Node) + name_len);
+    if (!new_node)
+    {
+        report_errno("Error al asignar memoria para el nodo");
         return NULL;
     }
 
+    new_node->name = (char *)(new_node + 1);
+    memcpy(new_node->name, name, name_len);
+
     new_node->type = type;
     new_node->parent = parent;
     new_node->child = NULL;
     new_node->sibling = NULL;
-    new_node->creation_time = time(NULL); 
+    new_node->creation_time = creation_time; 
+    new_node->time_entry = NULL;
+    new_node->name_entry = NULL;
+    new_node->arena = NULL;
+    new_node->last_access = 0;
+    new_node->stub = NULL;
+    new_node->radix = NULL;
+    return new_node;
+}
 
+// Crea un nodo con una fecha de creación dada (la inserta una sola vez en el índice)
+static Node *create_node_at(const char *name, NodeType type, Node *parent, time_t creation_time)
+{
+    Node *new_node = alloc_node(name, type, parent, creation_time);
+    if (!new_node)
+        return NULL;
+
+    new_node->time_entry = time_index_insert(new_node->creation_time, new_node);
+    new_node->name_entry = name_index_insert(new_node->name, new_node);
+    atomic_fetch_add(&spill_state.node_bytes, node_footprint(new_node));
+    return new_node;
+}
+
+Node *batch_create_node(NodeBatch *batch, const char *name, NodeType type, Node *parent, time_t creation_time)
+{
+    if (batch->count == NODE_BATCH_SIZE)
+        batch_flush(batch);
+
+    Node *new_node = alloc_node(name, type, parent, creation_time);
+    if (new_node)
+        batch->nodes[batch->count++] = new_node;
     return new_node;
 }
 
+// Completa la indexación de nodos que ya tienen su entrada en el índice de
+// nombres: los agrega al de fechas y suma su memoria. 'count' <= NODE_BATCH_SIZE.
+static void finish_indexing(Node *const *nodes, size_t count, NameEntry *const *name_entries)
+{
+    TimeEntry *time_entries[NODE_BATCH_SIZE];
+    time_index_insert_batch(nodes, count, time_entries);
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Node *node = nodes[i];
+        node->time_entry = time_entries[i];
+        node->name_entry = name_entries[i];
+        bytes += node_footprint(node);
+    }
+    atomic_fetch_add(&spill_state.node_bytes, bytes);
+}
+
+void batch_flush(NodeBatch *batch)
+{
+    if (batch->count == 0)
+        return;
+
+    NameEntry *name_entries[NODE_BATCH_SIZE];
+    name_index_insert_batch(batch->nodes, batch->count, name_entries, false);
+    finish_indexing(batch->nodes, batch->count, name_entries);
+    batch->count = 0;
+}
+
+Node *create_node(const char *name, NodeType type, Node *parent)
+{
+    return create_node_at(name, type, parent, time(NULL));
+}
+
 // Busca un nodo por su nombre y tipo en el árbol
 Node *find_node(Node *root, const char *name, NodeType type)
 {
-    if (!root || !name)
+    if (!name)
         return NULL;
 
-    // Verifica si el nodo actual coincide con el nombre y tipo buscado
-    if (strcmp(root->name, name) == 0 && root->type == type)
+    // Los hermanos se recorren con un ciclo para no agotar la pila en
+    // directorios con muchos hijos; solo se usa recursión para bajar de nivel
+    for (; root; root = root->sibling)
     {
-        return root;
-    }
+        // Verifica si el nodo actual coincide con el nombre y tipo buscado
+        if (strcmp(root->name, name) == 0 && root->type == type)
+        {
+            return root;
+        }
 
-    // Busca en los hijos del nodo actual
-    Node *found = find_node(root->child, name, type);
-    if (found)
-        return found;
+        // Un subárbol desalojado solo se recarga si su filtro indica que
+        // puede tener el nombre: una búsqueda fallida no toca el disco
+        if (root->stub && !stub_may_contain(root->stub, name))
+            continue;
+
+        // Busca en los hijos del nodo actual
+        Node *found = find_node(children_of(root), name, type);
+        if (found)
+            return found;
+    }
+    return NULL;
+}
 
-    // Busca en los hermanos del nodo actual
-    return find_node(root->sibling, name, type);
+// Cuelga 'child' de 'parent' y, si cambió de padre, actualiza el índice de nombres
+static void set_parent(Node *child, Node *parent)
+{
+    if (child->parent != parent)
+    {
+        child->parent = parent;
+        name_index_reparent(child->name_entry, parent);
+    }
 }
 
-void add_child(Node *parent, Node *child)
+bool add_child(Node *parent, Node *child)
 {
     if (!parent || !child)
-        return;
+        return false;
+
+    // Si los hijos desalojados no se pudieron recargar, el nodo nuevo se
+    // perdería al recargarlos más tarde
+    if (!load_children(parent))
+        return false;
 
-    child->parent = parent;
+    set_parent(child, parent);
 
     if (!parent->child)
     {
@@ -82,6 +305,26 @@ void add_child(Node *parent, Node *child)
         }
         sibling->sibling = child;
     }
+
+    if (parent->radix)
+        radix_insert(parent->radix, child->name, child);
+    return true;
+}
+
+bool add_child_after(Node *parent, Node *prev, Node *child)
+{
+    if (!prev)
+        return add_child(parent, child);
+    if (!parent || !child)
+        return false;
+
+    set_parent(child, parent);
+    child->sibling = prev->sibling;
+    prev->sibling = child;
+
+    if (parent->radix)
+        radix_insert(parent->radix, child->name, child);
+    return true;
 }
 
 void remove_node(Node *node)
@@ -92,6 +335,9 @@ void remove_node(Node *node)
     // Si el nodo tiene padre, reorganiza los hijos
     if (node->parent)
     {
+        if (node->parent->radix)
+            radix_remove(node->parent->radix, node->name, node);
+
         Node *sibling = node->parent->child;
         if (sibling == node)
         {
@@ -111,25 +357,162 @@ void remove_node(Node *node)
     }
 
     // Liberar memoria
-    free(node->name);
-    free(node);
+    destroy_node(node);
 }
 
 // Función para liberar todo el árbol de nodos recursivamente
 void free_tree(Node *root)
 {
-    if (!root)
+    // Los hermanos se liberan en el mismo ciclo, en grupos que se quitan
+    // juntos de los índices
+    Node *group[FREE_GROUP_SIZE];
+    while (root)
+    {
+        size_t count = 0;
+        while (root && count < FREE_GROUP_SIZE)
+        {
+            // Liberar todos los hijos recursivamente
+            free_tree(root->child);
+            group[count++] = root;
+            root = root->sibling;
+        }
+        destroy_nodes(group, count);
+    }
+}
+
+// Cantidad de nodos en memoria del árbol (los desalojados no cuentan)
+static size_t count_nodes(const Node *root)
+{
+    size_t count = 0;
+    for (; root; root = root->sibling)
+        count += 1 + count_nodes(root->child);
+    return count;
+}
+
+// Igual que free_tree, pero sin tocar los índices
+static void release_tree(Node *root)
+{
+    while (root)
+    {
+        Node *next = root->sibling;
+        release_tree(root->child);
+        if (root->stub)
+        {
+            unlink_stub(root->stub);
+            free(root->stub);
+        }
+        radix_free(root->radix);
+        atomic_fetch_sub(&spill_state.node_bytes, node_footprint(root));
+        release_node(root);
+        root = next;
+    }
+}
+
+void free_filesystem_tree(Node *root)
+{
+    // Si todos los nodos indexados son de este árbol, vaciar los índices de
+    // una vez es mucho más barato que quitar las entradas de a una
+    NameIndexStats names;
+    name_index_stats(&names);
+    size_t count = count_nodes(root);
+    if (count != time_index_size() || count != names.entries)
+    {
+        free_tree(root);
         return;
+    }
+    time_index_clear();
+    name_index_clear();
+    release_tree(root);
+}
+
+size_t add_children(Node *parent, const char *const *names, size_t count, NodeType type)
+{
+    if (!parent || !names || count == 0 || !load_children(parent))
+        return 0;
+
+    // Una sola pasada por los hijos existentes para encontrar el último hermano
+    Node *tail = NULL;
+    for (Node *child = children_of(parent); child; child = child->sibling)
+        tail = child;
+
+    // Los nodos se indexan por lotes: un bloqueo de cada índice por
+    // NODE_BATCH_SIZE nodos. El índice de nombres descarta los que ya existen
+    // entre los hijos del mismo tipo o se repiten en la lista, así que recién
+    // después se enlazan al final de los hermanos.
+    name_index_reserve(count);
+    time_t now = time(NULL);
+    Node *nodes[NODE_BATCH_SIZE];
+    NameEntry *name_entries[NODE_BATCH_SIZE];
+    size_t created = 0;
+    bool failed = false;
+    for (size_t i = 0; i < count && !failed;)
+    {
+        size_t batch_count = 0;
+        for (; i < count && batch_count < NODE_BATCH_SIZE; i++)
+        {
+            nodes[batch_count] = alloc_node(names[i], type, parent, now);
+            if (!nodes[batch_count])
+            {
+                failed = true;
+                break;
+            }
+            batch_count++;
+        }
+        name_index_insert_batch(nodes, batch_count, name_entries, true);
 
-    // Liberar todos los hijos recursivamente
-    free_tree(root->child);
+        size_t kept = 0;
+        for (size_t j = 0; j < batch_count; j++)
+        {
+            if (!name_entries[j])
+            {
+                release_node(nodes[j]);
+                continue;
+            }
+            nodes[kept] = nodes[j];
+            name_entries[kept] = name_entries[j];
+            kept++;
+        }
+        finish_indexing(nodes, kept, name_entries);
 
-    // Liberar todos los hermanos recursivamente
-    free_tree(root->sibling);
+        for (size_t j = 0; j < kept; j++)
+        {
+            add_child_after(parent, tail, nodes[j]);
+            tail = nodes[j];
+        }
+        created += kept;
+    }
+    return created;
+}
 
-    // Liberar el nodo actual
-    free(root->name);
-    free(root);
+size_t remove_children_if(Node *parent, NodeType type, bool (*match)(const char *name, void *ctx), void *ctx)
+{
+    if (!parent || !match)
+        return 0;
+
+    size_t removed = 0;
+    Node *prev = NULL;
+    Node *child = children_of(parent);
+    while (child)
+    {
+        Node *next = child->sibling;
+        if (child->type == type && !child->child && !child->stub && match(child->name, ctx))
+        {
+            if (prev)
+                prev->sibling = next;
+            else
+                parent->child = next;
+            if (parent->radix)
+                radix_remove(parent->radix, child->name, child);
+            destroy_node(child);
+            removed++;
+        }
+        else
+        {
+            prev = child;
+        }
+        child = next;
+    }
+    return removed;
 }
 
 const char *get_node_name(const Node *node)
@@ -149,7 +532,7 @@ Node *get_parent(const Node *node)
 
 Node *get_first_child(const Node *node)
 {
-    return node ? node->child : NULL;
+    return node ? children_of(node) : NULL;
 }
 
 Node *get_next_sibling(const Node *node)
@@ -162,6 +545,7 @@ Node *find_immediate_child(Node *parent, const char *name)
 {
     if (!parent)
         return NULL;
+    mark_accessed(parent);
     Node *child = get_first_child(parent);
     while (child)
     {
@@ -174,11 +558,152 @@ Node *find_immediate_child(Node *parent, const char *name)
     return NULL;
 }
 
+// Consulta la tabla (padre, nombre) del índice de nombres: O(1) esperado,
+// sin importar cuántos hijos tenga 'parent' ni cuántos nodos se llamen igual
+Node *find_child(const Node *parent, const char *name, NodeType type)
+{
+    if (!parent || !name)
+        return NULL;
+
+    // Los hijos desalojados no están en el índice
+    children_of(parent);
+
+    return name_index_find_child(parent, name, type);
+}
+
+bool has_child_named(const Node *parent, const char *name, NodeType type)
+{
+    return find_child(parent, name, type) != NULL;
+}
+
+// Hijo encontrado por find_children_with_prefix en un directorio chico
+typedef struct
+{
+    Node *node;
+    size_t position; // Orden entre hermanos: desempata nombres iguales
+} PrefixMatch;
+
+static int compare_matches(const void *a, const void *b)
+{
+    const PrefixMatch *x = a, *y = b;
+    int cmp = strcmp(x->node->name, y->node->name);
+    if (cmp != 0)
+        return cmp;
+    return x->position < y->position ? -1 : (x->position > y->position);
+}
+
+// Crea el árbol radix de un directorio con todos sus hijos actuales
+static void build_radix(Node *dir)
+{
+    dir->radix = radix_create();
+    if (!dir->radix)
+    {
+        report_errno("Error al asignar memoria para el árbol radix");
+        return;
+    }
+    for (Node *child = dir->child; child; child = child->sibling)
+    {
+        if (!radix_insert(dir->radix, child->name, child))
+        {
+            radix_free(dir->radix);
+            dir->radix = NULL;
+            return;
+        }
+    }
+}
+
+size_t find_children_with_prefix(Node *parent, const char *prefix, bool (*visit)(Node *node, void *ctx), void *ctx)
+{
+    if (!parent || !prefix || !visit)
+        return 0;
+
+    Node *first = children_of(parent);
+    if (!parent->radix)
+    {
+        size_t count = 0;
+        for (Node *child = first; child && count < RADIX_MIN_CHILDREN; child = child->sibling)
+            count++;
+        if (count >= RADIX_MIN_CHILDREN)
+        {
+            build_radix(parent);
+            if (!parent->radix)
+                return 0;
+        }
+    }
+    if (parent->radix)
+        return radix_prefix(parent->radix, prefix, visit, ctx);
+
+    // Directorio chico: se recorren los hijos y se ordenan igual que en el árbol radix
+    PrefixMatch matches[RADIX_MIN_CHILDREN];
+    size_t count = 0, position = 0;
+    size_t prefix_len = strlen(prefix);
+    for (Node *child = first; child; child = child->sibling, position++)
+    {
+        if (strncmp(child->name, prefix, prefix_len) == 0)
+            matches[count++] = (PrefixMatch){child, position};
+    }
+    qsort(matches, count, sizeof(PrefixMatch), compare_matches);
+
+    size_t visited = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        visited++;
+        if (!visit(matches[i].node, ctx))
+            break;
+    }
+    return visited;
+}
+
 time_t get_creation_time(const Node *node) {
     if (!node) return 0;
     return node->creation_time;
 }
 
+void set_creation_time(Node *node, time_t creation_time)
+{
+    if (!node || node->creation_time == creation_time)
+        return;
+
+    // Cambia la clave del índice: se reubica la entrada
+    time_index_remove(node->time_entry);
+    node->creation_time = creation_time;
+    node->time_entry = time_index_insert(creation_time, node);
+}
+
+size_t get_node_path(const Node *node, char *buffer, size_t size)
+{
+    if (!node || !buffer || size == 0)
+        return 0;
+
+    // Largo total: cada ancestro (menos la raíz) aporta "/<nombre>"
+    size_t len = 0;
+    for (const Node *n = node; n->parent; n = n->parent)
+        len += strlen(n->name) + 1;
+
+    if (len == 0)
+    {
+        snprintf(buffer, size, "/");
+        return 1;
+    }
+    if (len >= size)
+    {
+        buffer[0] = '\0';
+        return len;
+    }
+
+    // Se llena de atrás hacia adelante subiendo por los padres
+    buffer[len] = '\0';
+    size_t pos = len;
+    for (const Node *n = node; n->parent; n = n->parent)
+    {
+        size_t name_len = strlen(n->name);
+        pos -= name_len;
+        memcpy(buffer + pos, n->name, name_len);
+        buffer[--pos] = '/';
+    }
+    return len;
+}
+
 // Función auxiliar para formatear la fecha y hora
 void format_time(char *buffer, size_t buffer_size, time_t timestamp) 
 {
@@ -186,13 +711,27 @@ void format_time(char *buffer, size_t buffer_size, time_t timestamp)
     strftime(buffer, buffer_size, "%H:%M-%d/%m/%Y", timeinfo);
 }
 
+static bool write_preorder_node(FILE *file, const Node *node, const char *parent_path);
+
 // Función auxiliar que recorre el árbol en preorden y escribe cada nodo.
 // parent_path: camino absoluto del nodo padre. Para la raíz se pasa cadena vacía.
-void write_preorder(FILE *file, const Node *node, const char *parent_path)
+bool write_preorder(FILE *file, const Node *node, const char *parent_path)
 {
-    if (!node || !file)
-        return;
+    if (!file)
+        return false;
+
+    // Los hermanos se recorren con un ciclo; solo se usa recursión para bajar de nivel
+    for (; node; node = node->sibling)
+    {
+        if (!write_preorder_node(file, node, parent_path))
+            return false;
+    }
+    return true;
+}
 
+// Escribe un nodo y, recursivamente, sus descendientes
+static bool write_preorder_node(FILE *file, const Node *node, const char *parent_path)
+{
     char abs_path[1024];
     // Si el nodo es la raíz (no tiene padre), su camino absoluto es "/"
     if (node->parent == NULL)
@@ -219,9 +758,291 @@ void write_preorder(FILE *file, const Node *node, const char *parent_path)
     // nombre, fecha de creación, tipo y camino absoluto.
     fprintf(file, "%s\t%s\t%c\t%s\n", node->name, creation_date, type_letter, abs_path);
 
-    // Recorrido preorden: primero el hijo, luego el siguiente hermano.
-    write_preorder(file, node->child, abs_path);
-    write_preorder(file, node->sibling, parent_path);
+    // Recorrido preorden: primero los hijos; el siguiente hermano lo escribe quien llama.
+    // Si no se pueden recargar del archivo de desalojo la copia quedaría incompleta.
+    if (!load_children((Node *)node))
+        return false;
+    return write_preorder(file, node->child, abs_path);
+}
+
+// Estado del recorrido compacto: último camino escrito y su fecha de creación
+typedef struct
+{
+    char prev_path[MAX_PATH_LEN];
+    size_t prev_len;
+    time_t prev_time;
+} CompactWriter;
+
+// Escribe una entrada compacta: longitud del prefijo compartido con la entrada
+// anterior, tipo, diferencia de fecha con la entrada anterior y sufijo nuevo.
+static void write_compact_entry(FILE *file, const Node *node, const char *path, size_t len, CompactWriter *w)
+{
+    size_t max = len < w->prev_len ? len : w->prev_len;
+    size_t shared = 0;
+    while (shared < max && path[shared] == w->prev_path[shared])
+        shared++;
+
+    fprintf(file, "%zu\t%c\t%lld\t%s\n", shared, (node->type == DIR_TYPE) ? 'D' : 'F',
+            (long long)(node->creation_time - w->prev_time), path + shared);
+
+    memcpy(w->prev_path + shared, path + shared, len - shared + 1);
+    w->prev_len = len;
+    w->prev_time = node->creation_time;
+}
+
+// Recorre en preorden los hijos de un directorio cuyo camino ocupa path[0..len).
+// El buffer 'path' se extiende en sitio, sin recalcular el camino del padre.
+static bool write_compact_children(FILE *file, const Node *dir, char *path, size_t len, CompactWriter *w)
+{
+    // El hijo de la raíz es "/<nombre>", no "//<nombre>"
+    size_t base = (dir->parent == NULL) ? 0 : len;
+
+    if (!load_children((Node *)dir))
+        return false;
+    for (const Node *child = dir->child; child; child = child->sibling)
+    {
+        size_t name_len = strlen(child->name);
+        if (base + 1 + name_len >= MAX_PATH_LEN)
+        {
+            fprintf(error_stream(), "Error: Camino demasiado largo, se omite '%s'.\n", child->name);
+            continue;
+        }
+
+        path[base] = '/';
+        memcpy(path + base + 1, child->name, name_len + 1);
+        size_t child_len = base + 1 + name_len;
+
+        write_compact_entry(file, child, path, child_len, w);
+        if (!write_compact_children(file, child, path, child_len, w))
+            return false;
+    }
+    return true;
+}
+
+// Escribe el árbol completo en formato compacto, precedido por COMPACT_HEADER.
+bool write_preorder_compact(FILE *file, const Node *root)
+{
+    if (!file || !root)
+        return false;
+
+    CompactWriter w = {.prev_len = 0, .prev_time = 0};
+    w.prev_path[0] = '\0';
+
+    char path[MAX_PATH_LEN] = "/";
+
+    fprintf(file, "%s\n", COMPACT_HEADER);
+    write_compact_entry(file, root, path, 1, &w);
+    return write_compact_children(file, root, path, 1, &w);
+}
+
+// Lee un archivo escrito por write_preorder_compact. Cada línea tiene el formato:
+// <largo del prefijo compartido> \t <tipo> \t <delta de fecha> \t <sufijo>
+// Las entradas están en preorden, así que el padre de cada nodo es el nodo
+// anterior o alguno de sus ancestros: se mantiene una pila con ese camino.
+bool read_preorder_compact(FILE *file, Node *root)
+{
+    if (!file || !root)
+        return false;
+
+    char line[2 * MAX_PATH_LEN];
+    if (!fgets(line, sizeof(line), file) || strncmp(line, COMPACT_HEADER, strlen(COMPACT_HEADER)) != 0)
+        return false;
+
+    // Pila de ancestros: nodo, largo de su camino y último hijo agregado
+    Node *stack[MAX_PATH_LEN];
+    Node *last_child[MAX_PATH_LEN];
+    size_t stack_len[MAX_PATH_LEN];
+    size_t depth = 1;
+    stack[0] = root;
+    stack_len[0] = 0; // El padre de "/x" termina en la posición 0
+    last_child[0] = NULL;
+
+    char path[MAX_PATH_LEN] = "";
+    size_t path_len = 0;
+    time_t prev_time = 0;
+    NodeBatch batch = {.count = 0};
+
+    while (fgets(line, sizeof(line), file))
+    {
+        line[strcspn(line, "\n")] = '\0';
+        if (strlen(line) == 0)
+            continue;
+
+        char *end;
+        size_t shared = strtoul(line, &end, 10);
+        if (*end != '\t' || shared > path_len)
+            continue;
+        char type_char = end[1];
+        if (end[2] != '\t')
+            continue;
+        long long delta = strtoll(end + 3, &end, 10);
+        if (*end != '\t')
+            continue;
+        const char *suffix = end + 1;
+        size_t suffix_len = strlen(suffix);
+        if (shared + suffix_len >= MAX_PATH_LEN)
+            continue;
+
+        // Reconstruir el camino a partir del anterior
+        memcpy(path + shared, suffix, suffix_len + 1);
+        path_len = shared + suffix_len;
+        prev_time += (time_t)delta;
+
+        if (strcmp(path, "/") == 0)
+        {
+            set_creation_time(root, prev_time);
+            continue;
+        }
+
+        char *slash = strrchr(path, '/');
+        if (!slash || slash[1] == '\0')
+            continue;
+        size_t parent_len = (size_t)(slash - path);
+
+        // Desapilar hasta encontrar al padre
+        while (depth > 1 && stack_len[depth - 1] != parent_len)
+            depth--;
+        if (stack_len[depth - 1] != parent_len)
+            continue;
+
+        Node *parent = stack[depth - 1];
+        NodeType type = (type_char == 'D') ? DIR_TYPE : FILE_TYPE;
+        Node *new_node = batch_create_node(&batch, slash + 1, type, parent, prev_time);
+        if (!new_node)
+            break;
+        add_child_after(parent, last_child[depth - 1], new_node);
+        last_child[depth - 1] = new_node;
+
+        if (type == DIR_TYPE && depth < MAX_PATH_LEN)
+        {
+            stack[depth] = new_node;
+            stack_len[depth] = path_len;
+            last_child[depth] = NULL;
+            depth++;
+        }
+    }
+    batch_flush(&batch);
+    return true;
+}
+
+size_t traverse_tree(const Node *root)
+{
+    size_t visited = 0;
+    for (const Node *node = root; node; node = node->sibling)
+    {
+        // Se lee el nombre, como lo hacen ls y wrts
+        visited += (node->name[0] != '\0');
+        visited += traverse_tree(children_of(node));
+    }
+    return visited;
+}
+
+// Estado de compact_tree: próximas posiciones libres del bloque nuevo
+typedef struct
+{
+    Node *next_node;
+    char *next_name;
+    NodeArena *arena;
+    Node *old_current;
+    Node *new_current;
+} CompactState;
+
+// Cuenta los nodos y los bytes de nombres de un subárbol
+static void measure_tree(const Node *node, size_t *nodes, size_t *name_bytes)
+{
+    for (; node; node = node->sibling)
+    {
+        (*nodes)++;
+        *name_bytes += strlen(node->name) + 1;
+        measure_tree(node->child, nodes, name_bytes);
+    }
+}
+
+// Copia un nodo a su nueva posición y actualiza los índices que lo apuntan
+static void move_node(Node *old, Node *copy, Node *parent, CompactState *state)
+{
+    size_t name_len = strlen(old->name) + 1;
+    memcpy(state->next_name, old->name, name_len);
+
+    *copy = *old;
+    copy->name = state->next_name;
+    copy->parent = parent;
+    copy->child = NULL;
+    copy->sibling = NULL;
+    copy->arena = state->arena;
+    state->next_name += name_len;
+    state->arena->live++;
+
+    if (copy->stub)
+        copy->stub->dir = copy; // Sigue desalojado; solo cambia de dirección
+
+    time_index_relocate(copy->time_entry, copy);
+    name_index_relocate(copy->name_entry, copy);
+    if (old == state->old_current)
+        state->new_current = copy;
+}
+
+// Ubica los hijos de 'old_dir' uno al lado del otro a continuación de lo ya
+// copiado y luego baja a cada uno. Cada nodo viejo se libera apenas se copiaron sus hijos.
+static void compact_children(Node *old_dir, Node *new_dir, CompactState *state)
+{
+    Node *first = state->next_node;
+    Node *prev = NULL;
+    for (Node *child = old_dir->child; child; child = child->sibling)
+    {
+        Node *copy = state->next_node++;
+        move_node(child, copy, new_dir, state);
+        if (new_dir->radix)
+            radix_relocate(new_dir->radix, copy->name, child, copy);
+        if (prev)
+            prev->sibling = copy;
+        prev = copy;
+    }
+    new_dir->child = prev ? first : NULL;
+
+    Node *copy = first;
+    Node *child = old_dir->child;
+    while (child)
+    {
+        Node *next = child->sibling;
+        compact_children(child, copy, state);
+        release_node(child);
+        child = next;
+        copy++;
+    }
+}
+
+Node *compact_tree(Node *root, Node **current)
+{
+    if (!root)
+        return NULL;
+
+    // Solo se compacta un árbol completo, no una lista de hermanos
+    if (root->sibling)
+        return root;
+
+    size_t nodes = 1, name_bytes = strlen(root->name) + 1;
+    measure_tree(root->child, &nodes, &name_bytes);
+
+    NodeArena *arena = malloc(sizeof(NodeArena) + nodes * sizeof(Node) + name_bytes);
+    if (!arena)
+    {
+        report_errno("Error al asignar memoria para compactar el árbol");
+        return root;
+    }
+    arena->live = 0;
+
+    // Los nodos van justo después del encabezado; los nombres después de los nodos
+    Node *base = (Node *)(arena + 1);
+    CompactState state = {base + 1, (char *)(base + nodes), arena, current ? *current : NULL, NULL};
+
+    move_node(root, base, NULL, &state);
+    compact_children(root, base, &state);
+    release_node(root);
+
+    if (current && state.new_current)
+        *current = state.new_current;
+    return base;
 }
 
 // Función para imprimir la estructura del árbol (para depuración) esto se puede borrar luego
@@ -239,6 +1060,602 @@ void print_tree(const Node *root, int depth)
     printf("%s (%s)\n", root->name, root->type == DIR_TYPE ? "DIR" : "FILE");
 
     // Recursión para los hijos y hermanos
-    print_tree(root->child, depth + 1);
+    print_tree(children_of(root), depth + 1);
     print_tree(root->sibling, depth);
 }
+
+// ---------------------------------------------------------------------------
+// Desalojo de subárboles fríos
+//
+// Cuando la memoria supera el límite, los hijos de los directorios menos
+// usados se escriben en un archivo temporal y se liberan; el directorio queda
+// con un stub que indica dónde están. Cualquier acceso a sus hijos los vuelve
+// a cargar. Formato de un bloque: cantidad de hijos (uint32_t) y luego cada
+// nodo en preorden como SpillRecord + nombre (+ SpillRef y el filtro de su
+// stub si está desalojado). El filtro y el rango de fechas de cada stub le
+// permiten a las consultas globales recargar solo los subárboles candidatos.
+// ---------------------------------------------------------------------------
+
+typedef struct
+{
+    time_t creation_time;
+    uint32_t children;   // Hijos residentes escritos a continuación
+    uint16_t name_len;
+    uint8_t type;
+    uint8_t stubbed;     // Sus hijos ya estaban en el archivo
+} SpillRecord;
+
+typedef struct
+{
+    off_t offset;
+    uint64_t length;
+    uint64_t nodes;
+    int64_t min_time;
+    int64_t max_time;
+    uint64_t filter_words;
+} SpillRef;
+
+// Bits del filtro de Bloom de un stub por cada nodo desalojado, y posiciones
+// que marca cada nombre (con 8 y 3, menos de un 4% de falsos positivos)
+#define FILTER_BITS_PER_NODE 8
+#define FILTER_HASHES 3
+
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t capacity;
+} SpillBuffer;
+
+// Directorio candidato a desalojar
+typedef struct
+{
+    Node *dir;
+    uint64_t last_access; // Acceso más reciente de todo el subárbol
+    size_t depth;
+} SpillCandidate;
+
+typedef struct
+{
+    SpillCandidate *items;
+    size_t count;
+    size_t capacity;
+} CandidateList;
+
+void mark_accessed(Node *node)
+{
+    if (node)
+        node->last_access = atomic_fetch_add(&spill_state.tick, 1) + 1;
+}
+
+void set_memory_limit(size_t bytes)
+{
+    spill_state.limit = bytes;
+}
+
+size_t memory_usage()
+{
+    NameIndexStats names;
+    name_index_stats(&names);
+    return atomic_load(&spill_state.node_bytes) + time_index_memory() +
+           names.table_bytes + names.child_table_bytes + names.entry_bytes +
+           spill_state.stub_bytes;
+}
+
+void get_memory_stats(MemoryStats *stats)
+{
+    NameIndexStats names;
+    name_index_stats(&names);
+
+    stats->limit = spill_state.limit;
+    stats->node_bytes = atomic_load(&spill_state.node_bytes);
+    stats->time_index_bytes = time_index_memory();
+    stats->name_index_bytes = names.table_bytes + names.child_table_bytes + names.entry_bytes;
+    stats->stub_bytes = spill_state.stub_bytes;
+    stats->spilled_dirs = spill_state.stub_count;
+    stats->spilled_nodes = spill_state.spilled_nodes;
+    stats->spill_file_bytes = 0;
+    if (spill_state.file && fseeko(spill_state.file, 0, SEEK_END) == 0)
+        stats->spill_file_bytes = (size_t)ftello(spill_state.file);
+    stats->spills = spill_state.spills;
+    stats->faults = spill_state.faults;
+}
+
+static bool buffer_put(SpillBuffer *buf, const void *data, size_t len)
+{
+    if (buf->len + len > buf->capacity)
+    {
+        size_t capacity = buf->capacity ? buf->capacity : 4096;
+        while (capacity < buf->len + len)
+            capacity *= 2;
+        char *data_new = realloc(buf->data, capacity);
+        if (!data_new)
+            return false;
+        buf->data = data_new;
+        buf->capacity = capacity;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return true;
+}
+
+static uint32_t count_children(const Node *dir)
+{
+    uint32_t count = 0;
+    for (const Node *child = dir->child; child; child = child->sibling)
+        count++;
+    return count;
+}
+
+// Serializa una lista de hermanos y sus subárboles residentes
+static bool serialize_children(const Node *child, SpillBuffer *buf, size_t *nodes)
+{
+    for (; child; child = child->sibling)
+    {
+        size_t name_len = strlen(child->name);
+        if (name_len >= MAX_PATH_LEN)
+            return false;
+
+        SpillRecord rec = {child->creation_time, count_children(child), (uint16_t)name_len,
+                           (uint8_t)child->type, child->stub != NULL};
+        if (!buffer_put(buf, &rec, sizeof(rec)) || !buffer_put(buf, child->name, name_len))
+            return false;
+        (*nodes)++;
+
+        if (child->stub)
+        {
+            SpillRef ref = {child->stub->offset, child->stub->length, child->stub->nodes,
+                            child->stub->min_time, child->stub->max_time, child->stub->filter_words};
+            if (!buffer_put(buf, &ref, sizeof(ref)) ||
+                !buffer_put(buf, child->stub->filter, ref.filter_words * sizeof(uint64_t)))
+                return false;
+            *nodes += child->stub->nodes;
+        }
+        else if (!serialize_children(child->child, buf, nodes))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hash FNV-1a de 64 bits (el mismo de name_set.c)
+static uint64_t hash_name(const char *name)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+    {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Posición 'i' de un nombre en un filtro de 'bits' bits (potencia de dos).
+// Se toma el resto, así la posición en un filtro chico es la de uno más
+// grande recortada y se pueden combinar filtros de distinto tamaño.
+static uint64_t filter_bit(uint64_t hash, int i, uint64_t bits)
+{
+    return (hash + (uint64_t)i * ((hash >> 32) | 1)) & (bits - 1);
+}
+
+static void filter_add(SpillStub *stub, const char *name)
+{
+    uint64_t hash = hash_name(name);
+    uint64_t bits = (uint64_t)stub->filter_words * 64;
+    for (int i = 0; i < FILTER_HASHES; i++)
+    {
+        uint64_t bit = filter_bit(hash, i, bits);
+        stub->filter[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+// Indica si algún nodo del subárbol desalojado puede llamarse 'name'
+static bool stub_may_contain(const SpillStub *stub, const char *name)
+{
+    uint64_t hash = hash_name(name);
+    uint64_t bits = (uint64_t)stub->filter_words * 64;
+    for (int i = 0; i < FILTER_HASHES; i++)
+    {
+        uint64_t bit = filter_bit(hash, i, bits);
+        if (!(stub->filter[bit / 64] & (1ULL << (bit % 64))))
+            return false;
+    }
+    return true;
+}
+
+// Agrega al filtro de 'stub' los nombres del de 'nested'. Si los tamaños
+// difieren no aparecen falsos negativos: el más grande se pliega sobre el
+// chico, o el chico se repite a lo largo del grande.
+static void filter_merge(SpillStub *stub, const SpillStub *nested)
+{
+    uint32_t words = stub->filter_words > nested->filter_words ? stub->filter_words : nested->filter_words;
+    for (uint32_t i = 0; i < words; i++)
+        stub->filter[i & (stub->filter_words - 1)] |= nested->filter[i & (nested->filter_words - 1)];
+}
+
+static void widen_time_range(SpillStub *stub, time_t min_time, time_t max_time)
+{
+    if (min_time < stub->min_time)
+        stub->min_time = min_time;
+    if (max_time > stub->max_time)
+        stub->max_time = max_time;
+}
+
+// Agrega al filtro y al rango de fechas los nodos de una lista de hermanos y
+// de sus subárboles, incluidos los que ya estaban desalojados
+static void summarize_subtree(SpillStub *stub, const Node *child)
+{
+    for (; child; child = child->sibling)
+    {
+        filter_add(stub, child->name);
+        widen_time_range(stub, child->creation_time, child->creation_time);
+        if (child->stub)
+        {
+            filter_merge(stub, child->stub);
+            widen_time_range(stub, child->stub->min_time, child->stub->max_time);
+        }
+        else
+        {
+            summarize_subtree(stub, child->child);
+        }
+    }
+}
+
+static uint32_t filter_words_for(size_t nodes)
+{
+    uint32_t words = 1;
+    while ((size_t)words * 64 < nodes * FILTER_BITS_PER_NODE && words < (1U << 30))
+        words *= 2;
+    return words;
+}
+
+// Crea el stub de 'dir' con el filtro y el rango de fechas vacíos
+static SpillStub *attach_stub(Node *dir, off_t offset, size_t length, size_t nodes, uint32_t filter_words)
+{
+    SpillStub *stub = calloc(1, sizeof(SpillStub) + filter_words * sizeof(uint64_t));
+    if (!stub)
+        return NULL;
+    stub->filter_words = filter_words;
+    stub->min_time = (time_t)INT64_MAX;
+    stub->max_time = (time_t)INT64_MIN;
+    stub->dir = dir;
+    stub->offset = offset;
+    stub->length = length;
+    stub->nodes = nodes;
+    stub->prev = NULL;
+    stub->next = spill_state.stubs;
+    if (spill_state.stubs)
+        spill_state.stubs->prev = stub;
+    spill_state.stubs = stub;
+    spill_state.stub_count++;
+    spill_state.stub_bytes += sizeof(SpillStub) + filter_words * sizeof(uint64_t);
+    spill_state.spilled_nodes += nodes;
+    dir->stub = stub;
+    return stub;
+}
+
+// Escribe los hijos de 'dir' al archivo de desalojo y los libera
+static bool spill_dir(Node *dir)
+{
+    if (!spill_state.file)
+    {
+        spill_state.file = tmpfile();
+        if (!spill_state.file)
+        {
+            report_errno("Error al crear el archivo de desalojo");
+            return false;
+        }
+        spill_state.owner = getpid();
+    }
+    // Un hijo de bgsave comparte el archivo con el proceso principal
+    if (getpid() != spill_state.owner)
+        return false;
+
+    SpillBuffer buf = {NULL, 0, 0};
+    size_t nodes = 0;
+    uint32_t count = count_children(dir);
+    if (!buffer_put(&buf, &count, sizeof(count)) || !serialize_children(dir->child, &buf, &nodes))
+    {
+        fprintf(error_stream(), "Error: no se pudo serializar el directorio '%s'\n", dir->name);
+        free(buf.data);
+        return false;
+    }
+
+    // El espacio que liberan los bloques recargados solo se recupera cuando no queda ninguno
+    if (fseeko(spill_state.file, 0, SEEK_END) != 0)
+    {
+        report_errno("Error al escribir el archivo de desalojo");
+        free(buf.data);
+        return false;
+    }
+    off_t offset = ftello(spill_state.file);
+    if (fwrite(buf.data, 1, buf.len, spill_state.file) != buf.len || fflush(spill_state.file) != 0)
+    {
+        report_errno("Error al escribir el archivo de desalojo");
+        free(buf.data);
+        return false;
+    }
+    free(buf.data);
+
+    // Los stubs anidados se liberan con sus nodos; quedan referenciados en el bloque nuevo
+    Node *children = dir->child;
+    SpillStub *stub = attach_stub(dir, offset, buf.len, nodes, filter_words_for(nodes));
+    if (!stub)
+    {
+        report_errno("Error al asignar memoria para el desalojo");
+        return false;
+    }
+    summarize_subtree(stub, children);
+    dir->child = NULL;
+    free_tree(children);
+    // El índice por prefijo se vuelve a crear si se consulta después de recargarlo
+    radix_free(dir->radix);
+    dir->radix = NULL;
+    spill_state.spills++;
+    return true;
+}
+
+// Reconstruye 'count' hijos de 'parent' a partir de '*cursor'. Los nodos se
+// indexan por lotes en 'batch'.
+static bool restore_children(Node *parent, const char **cursor, const char *end, uint32_t count, NodeBatch *batch)
+{
+    Node *tail = NULL;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        SpillRecord rec;
+        if ((size_t)(end - *cursor) < sizeof(rec))
+            return false;
+        memcpy(&rec, *cursor, sizeof(rec));
+        *cursor += sizeof(rec);
+        if ((size_t)(end - *cursor) < rec.name_len || rec.name_len >= MAX_PATH_LEN)
+            return false;
+
+        char name[MAX_PATH_LEN];
+        memcpy(name, *cursor, rec.name_len);
+        name[rec.name_len] = '\0';
+        *cursor += rec.name_len;
+
+        Node *node = batch_create_node(batch, name, (NodeType)rec.type, parent, rec.creation_time);
+        if (!node)
+            return false;
+        // Vuelven tan fríos como estaba el directorio al desalojarse
+        node->last_access = parent->last_access;
+        if (tail)
+            tail->sibling = node;
+        else
+            parent->child = node;
+        tail = node;
+
+        if (rec.stubbed)
+        {
+            SpillRef ref;
+            if ((size_t)(end - *cursor) < sizeof(ref))
+                return false;
+            memcpy(&ref, *cursor, sizeof(ref));
+            *cursor += sizeof(ref);
+            // El filtro del stub anidado viaja en el bloque, a continuación
+            if (ref.filter_words == 0 || ref.filter_words > (1U << 30) || (ref.filter_words & (ref.filter_words - 1)) ||
+                (size_t)(end - *cursor) < ref.filter_words * sizeof(uint64_t))
+                return false;
+            SpillStub *stub = attach_stub(node, ref.offset, ref.length, ref.nodes, (uint32_t)ref.filter_words);
+            if (!stub)
+                return false;
+            memcpy(stub->filter, *cursor, ref.filter_words * sizeof(uint64_t));
+            stub->min_time = (time_t)ref.min_time;
+            stub->max_time = (time_t)ref.max_time;
+            *cursor += ref.filter_words * sizeof(uint64_t);
+        }
+        else if (!restore_children(node, cursor, end, rec.children, batch))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sin bloques referenciados (ni siquiera anidados), el archivo puede empezar
+// de nuevo. Un hijo de bgsave nunca lo trunca, porque el proceso principal lo
+// sigue usando, y el principal tampoco mientras viva un hijo que pueda leer
+// los bloques viejos: los siguientes se escribirían encima.
+static void reset_spill_file()
+{
+    if (spill_state.file && spill_state.stub_count == 0 && spill_state.pins == 0 &&
+        getpid() == spill_state.owner && ftruncate(fileno(spill_state.file), 0) != 0)
+        report_errno("Error al truncar el archivo de desalojo");
+}
+
+// Vuelve a cargar en memoria los hijos desalojados de 'dir'
+static bool fault_in(Node *dir)
+{
+    SpillStub *stub = dir->stub;
+    char *data = malloc(stub->length);
+    if (!data)
+    {
+        report_errno("Error al asignar memoria para recargar un directorio");
+        return false;
+    }
+    ssize_t got = pread(fileno(spill_state.file), data, stub->length, stub->offset);
+    if (got != (ssize_t)stub->length)
+    {
+        // Un bloque incompleto significa que el archivo se truncó o se dañó
+        if (got < 0)
+            report_errno("Error al leer el archivo de desalojo");
+        else
+            fprintf(error_stream(), "Error: el archivo de desalojo está dañado ('%s')\n", dir->name);
+        free(data);
+        return false;
+    }
+
+    const char *end = data + stub->length;
+    dir->stub = NULL;
+    unlink_stub(stub);
+    free(stub);
+
+    uint32_t count;
+    memcpy(&count, data, sizeof(count));
+    const char *cursor = data + sizeof(count);
+    NodeBatch batch = {.count = 0};
+    bool ok = restore_children(dir, &cursor, end, count, &batch);
+    if (!ok)
+        fprintf(error_stream(), "Error: el archivo de desalojo está dañado ('%s')\n", dir->name);
+    batch_flush(&batch);
+    free(data);
+    spill_state.faults++;
+
+    reset_spill_file();
+    return ok;
+}
+
+void spill_file_pin()
+{
+    spill_state.pins++;
+}
+
+void spill_file_unpin()
+{
+    if (spill_state.pins > 0 && --spill_state.pins == 0)
+        reset_spill_file();
+}
+
+// Recarga los stubs que cumplen 'match', incluidos los anidados que aparecen
+// al recargar otros. Devuelve cuántos recargó.
+static size_t load_matching_stubs(bool (*match)(const SpillStub *stub, const void *ctx), const void *ctx)
+{
+    size_t loaded = 0;
+    SpillStub *stub = spill_state.stubs;
+    while (stub)
+    {
+        if (!match(stub, ctx))
+        {
+            stub = stub->next;
+            continue;
+        }
+        if (!fault_in(stub->dir))
+            break;
+        loaded++;
+        // Los stubs anidados se agregan al principio de la lista
+        stub = spill_state.stubs;
+    }
+    return loaded;
+}
+
+static bool stub_matches_name(const SpillStub *stub, const void *name)
+{
+    return stub_may_contain(stub, name);
+}
+
+static bool stub_matches_range(const SpillStub *stub, const void *range)
+{
+    const time_t *bounds = range;
+    return stub->min_time <= bounds[1] && stub->max_time >= bounds[0];
+}
+
+size_t load_spilled_named(const char *name)
+{
+    return load_matching_stubs(stub_matches_name, name);
+}
+
+size_t load_spilled_in_range(time_t from, time_t to)
+{
+    time_t bounds[2] = {from, to};
+    return load_matching_stubs(stub_matches_range, bounds);
+}
+
+static bool candidate_push(CandidateList *list, Node *dir, uint64_t last_access, size_t depth)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 64;
+        SpillCandidate *items = realloc(list->items, capacity * sizeof(SpillCandidate));
+        if (!items)
+            return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = (SpillCandidate){dir, last_access, depth};
+    return true;
+}
+
+// Recorre los directorios residentes sin cargar nada y devuelve el acceso más
+// reciente del subárbol. 'path' es el camino de la raíz al directorio actual,
+// que nunca se desaloja.
+static uint64_t collect_candidates(Node *dir, size_t depth, Node *const *path, size_t path_len,
+                                   CandidateList *list)
+{
+    uint64_t newest = dir->last_access;
+    for (Node *child = dir->child; child; child = child->sibling)
+    {
+        if (child->type == DIR_TYPE && !child->stub)
+        {
+            uint64_t access = collect_candidates(child, depth + 1, path, path_len, list);
+            if (access > newest)
+                newest = access;
+        }
+        else if (child->last_access > newest)
+        {
+            newest = child->last_access;
+        }
+    }
+
+    bool on_path = depth < path_len && path[depth] == dir;
+    if (dir->child && !on_path)
+        candidate_push(list, dir, newest, depth);
+    return newest;
+}
+
+// Primero lo menos usado; a igual uso, los más profundos (los hijos antes que sus padres)
+static int compare_candidates(const void *a, const void *b)
+{
+    const SpillCandidate *x = a, *y = b;
+    if (x->last_access != y->last_access)
+        return x->last_access < y->last_access ? -1 : 1;
+    if (x->depth != y->depth)
+        return x->depth > y->depth ? -1 : 1;
+    return 0;
+}
+
+size_t enforce_memory_limit(Node *root, Node *current)
+{
+    if (!spill_state.limit || !root || memory_usage() <= spill_state.limit)
+        return 0;
+
+    // Se baja hasta el 90% del límite para no desalojar en cada comando
+    size_t target = spill_state.limit / 10 * 9;
+
+    size_t path_len = 0;
+    for (Node *node = current; node; node = node->parent)
+        path_len++;
+    Node **path = malloc((path_len ? path_len : 1) * sizeof(Node *));
+    if (!path)
+    {
+        report_errno("Error al asignar memoria para el desalojo");
+        return 0;
+    }
+    size_t i = path_len;
+    for (Node *node = current; node; node = node->parent)
+        path[--i] = node;
+
+    // La raíz tampoco se desaloja: siempre es el comienzo del camino
+    if (path_len == 0 || path[0] != root)
+    {
+        path[0] = root;
+        path_len = 1;
+    }
+
+    CandidateList list = {NULL, 0, 0};
+    collect_candidates(root, 0, path, path_len, &list);
+    if (list.count > 1)
+        qsort(list.items, list.count, sizeof(SpillCandidate), compare_candidates);
+
+    size_t before = spill_state.spilled_nodes;
+    for (size_t j = 0; j < list.count && memory_usage() > target; j++)
+    {
+        if (!spill_dir(list.items[j].dir))
+            break;
+    }
+
+    free(list.items);
+    free(path);
+    return spill_state.spilled_nodes - before;
+}
@@ -0,0 +1,377 @@
+#define _GNU_SOURCE
+#include "include/pipeline.h"
+#include "include/dispatch.h"
+#include "include/error.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RECORD_RING_SIZE 256          // Potencia de dos
+#define OUTPUT_RING_SIZE (1 << 20)    // Potencia de dos
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+#define ERROR_RING_SIZE 64            // Potencia de dos
+#define ERROR_TEXT_SIZE 512
+
+// Cola de comandos tokenizados: el lector produce y el ejecutor consume.
+// 'head' y 'tail' crecen sin límite; la posición real es el valor módulo el tamaño.
+typedef struct
+{
+    CommandRecord slots[RECORD_RING_SIZE];
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    atomic_bool done;   // El lector llegó al final de la entrada
+} RecordRing;
+
+// Cola de bytes de salida: el ejecutor produce y el escritor consume
+typedef struct
+{
+    char data[OUTPUT_RING_SIZE];
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    atomic_bool done;   // El ejecutor terminó
+} ByteRing;
+
+// Mensaje de error del ejecutor. El escritor lo pasa a stderr cuando ya
+// escribió los primeros 'position' bytes de la salida, así queda en el mismo
+// lugar que en el intérprete secuencial.
+typedef struct
+{
+    size_t position;
+    size_t length;
+    char text[ERROR_TEXT_SIZE];
+} ErrorRecord;
+
+// Cola de mensajes de error: el ejecutor produce y el escritor consume
+typedef struct
+{
+    ErrorRecord slots[ERROR_RING_SIZE];
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+} ErrorRing;
+
+typedef struct
+{
+    FILE *input;
+    RecordRing *records;
+    ByteRing *output;
+    ErrorRing *errors;
+    FILE *out;          // Salida del ejecutor, que escribe en 'output'
+} PipelineState;
+
+// La etapa de escritura usa stdout y stderr con este bloqueo tomado, y un fork
+// (bgsave) lo toma antes de duplicar el proceso. Así la etapa nunca queda a
+// mitad de una escritura, con el bloqueo interno de esos FILE tomado, en un
+// hijo donde ningún hilo lo liberaría.
+static pthread_mutex_t stream_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t fork_handlers_once = PTHREAD_ONCE_INIT;
+
+static void lock_streams()
+{
+    pthread_mutex_lock(&stream_lock);
+}
+
+static void unlock_streams()
+{
+    pthread_mutex_unlock(&stream_lock);
+}
+
+static void register_fork_handlers()
+{
+    pthread_atfork(lock_streams, unlock_streams, unlock_streams);
+}
+
+// Espera activa breve y luego con pausas, para no ocupar la CPU cuando la
+// entrada es interactiva
+static void backoff(unsigned *spins)
+{
+    if (++*spins < 64)
+    {
+        sched_yield();
+    }
+    else
+    {
+        struct timespec pause = {0, 100000};
+        nanosleep(&pause, NULL);
+    }
+}
+
+// Etapa 1: lee líneas y las convierte en registros de comando
+static void *reader_stage(void *arg)
+{
+    PipelineState *state = arg;
+    RecordRing *ring = state->records;
+    char input[MAX_CMD];
+
+    while (fgets(input, sizeof(input), state->input))
+    {
+        // Eliminar el salto de línea
+        input[strcspn(input, "\n")] = '\0';
+
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned spins = 0;
+        while (tail - atomic_load_explicit(&ring->head, memory_order_acquire) == RECORD_RING_SIZE)
+            backoff(&spins);
+
+        parse_command(input, &ring->slots[tail & (RECORD_RING_SIZE - 1)]);
+        atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    }
+
+    atomic_store_explicit(&ring->done, true, memory_order_release);
+    return NULL;
+}
+
+// Etapa 3: vacía la cola de salida en la salida estándar e intercala los
+// mensajes de error en stderr. Mientras dura el modo en tubería este es el
+// único hilo que usa stdout y stderr.
+static void *writer_stage(void *arg)
+{
+    ByteRing *ring = ((PipelineState *)arg)->output;
+    ErrorRing *errors = ((PipelineState *)arg)->errors;
+    unsigned spins = 0;
+
+    for (;;)
+    {
+        // Primero la cola de errores: la salida que precede a un mensaje ya
+        // está en la cola de bytes cuando el mensaje se publica
+        size_t error_head = atomic_load_explicit(&errors->head, memory_order_relaxed);
+        bool error_pending = atomic_load_explicit(&errors->tail, memory_order_acquire) != error_head;
+        size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (error_pending)
+        {
+            const ErrorRecord *error = &errors->slots[error_head & (ERROR_RING_SIZE - 1)];
+            if (error->position == head)
+            {
+                lock_streams();
+                fflush(stdout);
+                fwrite(error->text, 1, error->length, stderr);
+                unlock_streams();
+                atomic_store_explicit(&errors->head, error_head + 1, memory_order_release);
+                spins = 0;
+                continue;
+            }
+            // Solo se escribe la salida anterior al mensaje
+            tail = error->position;
+        }
+        if (head == tail)
+        {
+            if (atomic_load_explicit(&ring->done, memory_order_acquire) &&
+                atomic_load_explicit(&ring->tail, memory_order_acquire) == head &&
+                atomic_load_explicit(&errors->tail, memory_order_acquire) == error_head)
+                break;
+            if (spins == 0)
+            {
+                lock_streams();
+                fflush(stdout);
+                unlock_streams();
+            }
+            backoff(&spins);
+            continue;
+        }
+        spins = 0;
+
+        // Bloque contiguo hasta el final del buffer circular
+        size_t offset = head & (OUTPUT_RING_SIZE - 1);
+        size_t len = tail - head;
+        if (len > OUTPUT_RING_SIZE - offset)
+            len = OUTPUT_RING_SIZE - offset;
+
+        // Si la escritura falla el bloque se descarta igual, para no bloquear al ejecutor
+        lock_streams();
+        fwrite(ring->data + offset, 1, len, stdout);
+        unlock_streams();
+        atomic_store_explicit(&ring->head, head + len, memory_order_release);
+    }
+    lock_streams();
+    fflush(stdout);
+    unlock_streams();
+    return NULL;
+}
+
+// Función de escritura del FILE que usa el ejecutor: copia a la cola de salida
+static ssize_t output_write(void *cookie, const char *buf, size_t size)
+{
+    ByteRing *ring = cookie;
+    size_t copied = 0;
+    unsigned spins = 0;
+
+    while (copied < size)
+    {
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t free_space = OUTPUT_RING_SIZE - (tail - atomic_load_explicit(&ring->head, memory_order_acquire));
+        if (free_space == 0)
+        {
+            backoff(&spins);
+            continue;
+        }
+
+        size_t offset = tail & (OUTPUT_RING_SIZE - 1);
+        size_t len = size - copied;
+        if (len > free_space)
+            len = free_space;
+        if (len > OUTPUT_RING_SIZE - offset)
+            len = OUTPUT_RING_SIZE - offset;
+
+        memcpy(ring->data + offset, buf + copied, len);
+        atomic_store_explicit(&ring->tail, tail + len, memory_order_release);
+        copied += len;
+    }
+    return (ssize_t)size;
+}
+
+// Función de escritura del FILE de errores del ejecutor: publica el mensaje
+// junto con la cantidad de bytes de salida que deben escribirse antes. Los
+// hilos de import también escriben en él; el bloqueo del FILE los serializa,
+// así que la cola sigue teniendo un solo productor a la vez.
+static ssize_t error_write(void *cookie, const char *buf, size_t size)
+{
+    PipelineState *state = cookie;
+    ErrorRing *ring = state->errors;
+
+    // Lo que el comando ya escribió en la salida va antes que el mensaje
+    fflush(state->out);
+    size_t position = atomic_load_explicit(&state->output->tail, memory_order_relaxed);
+
+    size_t copied = 0;
+    unsigned spins = 0;
+    while (copied < size)
+    {
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        if (tail - atomic_load_explicit(&ring->head, memory_order_acquire) == ERROR_RING_SIZE)
+        {
+            backoff(&spins);
+            continue;
+        }
+
+        ErrorRecord *error = &ring->slots[tail & (ERROR_RING_SIZE - 1)];
+        size_t len = size - copied;
+        if (len > ERROR_TEXT_SIZE)
+            len = ERROR_TEXT_SIZE;
+        error->position = position;
+        error->length = len;
+        memcpy(error->text, buf + copied, len);
+        atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+        copied += len;
+    }
+    return (ssize_t)size;
+}
+
+// Libera las colas del modo en tubería
+static void free_state(PipelineState *state)
+{
+    free(state->records);
+    free(state->output);
+    free(state->errors);
+}
+
+void run_pipeline(FileSystem *fs, FILE *input)
+{
+    // Las colas separan 'head' y 'tail' en líneas de caché distintas
+    PipelineState state = {input, aligned_alloc(64, sizeof(RecordRing)), aligned_alloc(64, sizeof(ByteRing)),
+                           aligned_alloc(64, sizeof(ErrorRing)), NULL};
+    if (!state.records || !state.output || !state.errors)
+    {
+        perror("Error al asignar memoria para el modo en tubería");
+        free_state(&state);
+        return;
+    }
+    memset(state.records, 0, sizeof(RecordRing));
+    memset(state.output, 0, sizeof(ByteRing));
+    memset(state.errors, 0, sizeof(ErrorRing));
+
+    cookie_io_functions_t functions = {.write = output_write};
+    FILE *out = fopencookie(state.output, "w", functions);
+    cookie_io_functions_t error_functions = {.write = error_write};
+    FILE *err = fopencookie(&state, "w", error_functions);
+    if (!out || !err)
+    {
+        perror("Error al crear la salida del modo en tubería");
+        if (out)
+            fclose(out);
+        if (err)
+            fclose(err);
+        free_state(&state);
+        return;
+    }
+    setvbuf(out, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+    pthread_once(&fork_handlers_once, register_fork_handlers);
+    // Sin búfer, como stderr: cada mensaje se publica en cuanto se escribe
+    setvbuf(err, NULL, _IONBF, 0);
+    state.out = out;
+
+    pthread_t reader, writer;
+    if (pthread_create(&writer, NULL, writer_stage, &state) != 0)
+    {
+        perror("Error al crear el hilo de escritura");
+        fclose(err);
+        fclose(out);
+        free_state(&state);
+        return;
+    }
+    if (pthread_create(&reader, NULL, reader_stage, &state) != 0)
+    {
+        perror("Error al crear el hilo de lectura");
+        fclose(err);
+        fclose(out);
+        atomic_store(&state.output->done, true);
+        pthread_join(writer, NULL);
+        free_state(&state);
+        return;
+    }
+
+    // Etapa 2: el hilo actual ejecuta los comandos en orden
+    FILE *previous_out = fs->out, *previous_err = fs->err;
+    fs->out = out;
+    fs->err = err;
+    set_error_stream(err);
+    RecordRing *ring = state.records;
+    bool input_closed = false;
+
+    fprintf(out, "> ");
+    for (;;)
+    {
+        size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        unsigned spins = 0;
+        while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head)
+        {
+            if (atomic_load_explicit(&ring->done, memory_order_acquire) &&
+                atomic_load_explicit(&ring->tail, memory_order_acquire) == head)
+            {
+                input_closed = true;
+                break;
+            }
+            // Sin comandos pendientes: lo ya producido se entrega antes de esperar
+            if (spins == 0)
+                fflush(out);
+            backoff(&spins);
+        }
+        if (input_closed)
+            break;
+
+        CommandResult result = execute_command(fs, &ring->slots[head & (RECORD_RING_SIZE - 1)]);
+        atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+        if (result == RESULT_EXIT)
+            break;
+
+        fprintf(out, "> ");
+    }
+
+    fs->out = previous_out;
+    fs->err = previous_err;
+    set_error_stream(previous_err);
+    fclose(err);
+    fclose(out);
+    atomic_store_explicit(&state.output->done, true, memory_order_release);
+
+    // Tras 'exit' el lector puede seguir esperando entrada: se cancela
+    if (!input_closed)
+        pthread_cancel(reader);
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+
+    free_state(&state);
+}
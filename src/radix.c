@@ -0,0 +1,312 @@
+#include "include/radix.h"
+#include "include/error.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Nodo del árbol: la etiqueta es el tramo del nombre desde el padre. Los
+// hijos están ordenados por su primer byte, así el recorrido sale ordenado.
+typedef struct RadixNode
+{
+    char *label;
+    size_t label_len;
+    Node **values;          // Nodos cuyo nombre termina aquí, en orden de inserción
+    size_t value_count;
+    struct RadixNode **children;
+    size_t child_count;
+    size_t child_capacity;
+} RadixNode;
+
+struct RadixTree
+{
+    RadixNode root; // Etiqueta vacía
+};
+
+static RadixNode *radix_node_create(const char *label, size_t label_len)
+{
+    RadixNode *node = calloc(1, sizeof(RadixNode));
+    if (!node)
+        return NULL;
+    node->label = malloc(label_len + 1);
+    if (!node->label)
+    {
+        free(node);
+        return NULL;
+    }
+    memcpy(node->label, label, label_len);
+    node->label[label_len] = '\0';
+    node->label_len = label_len;
+    return node;
+}
+
+static void radix_node_free(RadixNode *node)
+{
+    for (size_t i = 0; i < node->child_count; i++)
+        radix_node_free(node->children[i]);
+    free(node->children);
+    free(node->values);
+    free(node->label);
+    free(node);
+}
+
+// Posición del hijo que empieza con 'c', o donde debería insertarse
+static size_t child_slot(const RadixNode *node, unsigned char c, bool *found)
+{
+    size_t lo = 0, hi = node->child_count;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        unsigned char first = (unsigned char)node->children[mid]->label[0];
+        if (first == c)
+        {
+            *found = true;
+            return mid;
+        }
+        if (first < c)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    *found = false;
+    return lo;
+}
+
+static bool insert_child(RadixNode *node, size_t pos, RadixNode *child)
+{
+    if (node->child_count == node->child_capacity)
+    {
+        size_t capacity = node->child_capacity ? node->child_capacity * 2 : 2;
+        RadixNode **children = realloc(node->children, capacity * sizeof(RadixNode *));
+        if (!children)
+            return false;
+        node->children = children;
+        node->child_capacity = capacity;
+    }
+    memmove(node->children + pos + 1, node->children + pos, (node->child_count - pos) * sizeof(RadixNode *));
+    node->children[pos] = child;
+    node->child_count++;
+    return true;
+}
+
+static bool add_value(RadixNode *node, Node *value)
+{
+    Node **values = realloc(node->values, (node->value_count + 1) * sizeof(Node *));
+    if (!values)
+        return false;
+    values[node->value_count++] = value;
+    node->values = values;
+    return true;
+}
+
+static size_t common_prefix(const char *a, size_t a_len, const char *b)
+{
+    size_t i = 0;
+    while (i < a_len && a[i] == b[i])
+        i++;
+    return i;
+}
+
+RadixTree *radix_create()
+{
+    return calloc(1, sizeof(RadixTree));
+}
+
+bool radix_insert(RadixTree *tree, const char *name, Node *node)
+{
+    if (!tree || !name)
+        return false;
+
+    RadixNode *current = &tree->root;
+    const char *key = name;
+    while (*key)
+    {
+        bool found;
+        size_t pos = child_slot(current, (unsigned char)key[0], &found);
+        if (!found)
+        {
+            // Ningún hijo comparte el primer byte: el resto del nombre es una hoja nueva
+            RadixNode *leaf = radix_node_create(key, strlen(key));
+            if (!leaf || !add_value(leaf, node) || !insert_child(current, pos, leaf))
+            {
+                if (leaf)
+                    radix_node_free(leaf);
+                report_errno("Error al asignar memoria para el árbol radix");
+                return false;
+            }
+            return true;
+        }
+
+        RadixNode *child = current->children[pos];
+        size_t shared = common_prefix(child->label, child->label_len, key);
+        if (shared < child->label_len)
+        {
+            // El nombre se separa a mitad de la etiqueta: se parte la arista
+            RadixNode *middle = radix_node_create(child->label, shared);
+            if (!middle || !insert_child(middle, 0, child))
+            {
+                if (middle)
+                    radix_node_free(middle);
+                report_errno("Error al asignar memoria para el árbol radix");
+                return false;
+            }
+            child->label_len -= shared;
+            memmove(child->label, child->label + shared, child->label_len + 1);
+            current->children[pos] = middle;
+            child = middle;
+        }
+        current = child;
+        key += shared;
+    }
+
+    if (!add_value(current, node))
+    {
+        report_errno("Error al asignar memoria para el árbol radix");
+        return false;
+    }
+    return true;
+}
+
+// Une un nodo sin valores con su único hijo
+static bool merge_with_child(RadixNode **slot)
+{
+    RadixNode *node = *slot;
+    RadixNode *child = node->children[0];
+    char *label = malloc(node->label_len + child->label_len + 1);
+    if (!label)
+        return false;
+    memcpy(label, node->label, node->label_len);
+    memcpy(label + node->label_len, child->label, child->label_len + 1);
+    free(child->label);
+    child->label = label;
+    child->label_len += node->label_len;
+
+    node->child_count = 0;
+    radix_node_free(node);
+    *slot = child;
+    return true;
+}
+
+// Quita 'value' del subárbol de 'current' y deja el árbol comprimido.
+static bool remove_rec(RadixNode *current, const char *key, const Node *value)
+{
+    if (!*key)
+    {
+        for (size_t i = 0; i < current->value_count; i++)
+        {
+            if (current->values[i] == value)
+            {
+                memmove(current->values + i, current->values + i + 1,
+                        (current->value_count - i - 1) * sizeof(Node *));
+                current->value_count--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool found;
+    size_t pos = child_slot(current, (unsigned char)key[0], &found);
+    if (!found)
+        return false;
+    RadixNode *child = current->children[pos];
+    if (strncmp(child->label, key, child->label_len) != 0)
+        return false;
+    if (!remove_rec(child, key + child->label_len, value))
+        return false;
+
+    if (child->value_count == 0 && child->child_count == 0)
+    {
+        radix_node_free(child);
+        memmove(current->children + pos, current->children + pos + 1,
+                (current->child_count - pos - 1) * sizeof(RadixNode *));
+        current->child_count--;
+    }
+    else if (child->value_count == 0 && child->child_count == 1)
+    {
+        // Si falla la memoria el árbol queda sin comprimir, pero sigue siendo correcto
+        merge_with_child(&current->children[pos]);
+    }
+    return true;
+}
+
+void radix_remove(RadixTree *tree, const char *name, const Node *node)
+{
+    if (tree && name)
+        remove_rec(&tree->root, name, node);
+}
+
+// Baja por el árbol siguiendo 'key'. Si 'key' termina a mitad de una
+// etiqueta devuelve ese hijo (todo su subárbol comparte el prefijo).
+static RadixNode *descend(const RadixNode *current, const char *key, bool exact)
+{
+    while (*key)
+    {
+        bool found;
+        size_t pos = child_slot(current, (unsigned char)key[0], &found);
+        if (!found)
+            return NULL;
+        RadixNode *child = current->children[pos];
+        size_t shared = common_prefix(child->label, child->label_len, key);
+        if (shared < child->label_len)
+            return (!exact && key[shared] == '\0') ? child : NULL;
+        current = child;
+        key += shared;
+    }
+    return (RadixNode *)current;
+}
+
+void radix_relocate(RadixTree *tree, const char *name, const Node *old, Node *node)
+{
+    if (!tree || !name)
+        return;
+
+    RadixNode *leaf = descend(&tree->root, name, true);
+    for (size_t i = 0; leaf && i < leaf->value_count; i++)
+    {
+        if (leaf->values[i] == old)
+        {
+            leaf->values[i] = node;
+            return;
+        }
+    }
+}
+
+// Visita un subárbol en orden; devuelve false si el visitante pidió parar
+static bool visit_subtree(const RadixNode *node, RadixVisitor visit, void *ctx, size_t *visited)
+{
+    for (size_t i = 0; i < node->value_count; i++)
+    {
+        (*visited)++;
+        if (!visit(node->values[i], ctx))
+            return false;
+    }
+    for (size_t i = 0; i < node->child_count; i++)
+    {
+        if (!visit_subtree(node->children[i], visit, ctx, visited))
+            return false;
+    }
+    return true;
+}
+
+size_t radix_prefix(const RadixTree *tree, const char *prefix, RadixVisitor visit, void *ctx)
+{
+    if (!tree || !prefix || !visit)
+        return 0;
+
+    size_t visited = 0;
+    const RadixNode *start = descend(&tree->root, prefix, false);
+    if (start)
+        visit_subtree(start, visit, ctx, &visited);
+    return visited;
+}
+
+void radix_free(RadixTree *tree)
+{
+    if (!tree)
+        return;
+    for (size_t i = 0; i < tree->root.child_count; i++)
+        radix_node_free(tree->root.children[i]);
+    free(tree->root.children);
+    free(tree->root.values);
+    free(tree);
+}
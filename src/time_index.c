@@ -0,0 +1,290 @@
+#include "include/time_index.h"
+#include "include/error.h"
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_LEVEL 24
+
+// Entrada de la lista de saltos. El orden es (fecha, secuencia): la secuencia
+// desempata nodos creados en el mismo segundo y permite ubicar una entrada concreta.
+struct TimeEntry
+{
+    time_t time;
+    uint64_t seq;
+    Node *node;
+    TimeEntry *prev;  // Solo en el nivel 0, para recorrer hacia atrás
+    int level;
+    TimeEntry *next[];
+};
+
+static struct
+{
+    pthread_mutex_t lock;
+    TimeEntry *head[MAX_LEVEL];
+    TimeEntry *tail[MAX_LEVEL]; // Último elemento de cada nivel: inserción al final en O(nivel)
+    int level;
+    size_t size;
+    size_t bytes;     // Memoria de las entradas, medida con malloc_usable_size
+    uint64_t next_seq;
+} index_state = {.lock = PTHREAD_MUTEX_INITIALIZER, .level = 1};
+
+// Nivel pseudoaleatorio con probabilidad 1/4 de subir. Se obtiene mezclando
+// la dirección del nodo (splitmix64), así no depende de un estado compartido
+// y las entradas se pueden reservar fuera del bloqueo.
+static int random_level(const Node *node)
+{
+    uint64_t x = (uint64_t)(uintptr_t)node + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+
+    int level = 1;
+    while (level < MAX_LEVEL && (x & 3) == 0)
+    {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+static bool entry_less(const TimeEntry *e, time_t time, uint64_t seq)
+{
+    return e->time < time || (e->time == time && e->seq < seq);
+}
+
+// Llena 'preds' con el último elemento menor que (time, seq) en cada nivel (NULL = cabeza)
+static void find_preds(time_t time, uint64_t seq, TimeEntry **preds)
+{
+    TimeEntry *pred = NULL;
+    for (int i = index_state.level - 1; i >= 0; i--)
+    {
+        TimeEntry *next = pred ? pred->next[i] : index_state.head[i];
+        while (next && entry_less(next, time, seq))
+        {
+            pred = next;
+            next = next->next[i];
+        }
+        preds[i] = pred;
+    }
+}
+
+// Reserva una entrada (sin enlazarla) para el nodo
+static TimeEntry *new_entry(time_t creation_time, Node *node)
+{
+    int level = random_level(node);
+    TimeEntry *entry = malloc(sizeof(TimeEntry) + (size_t)level * sizeof(TimeEntry *));
+    if (!entry)
+    {
+        report_errno("Error al asignar memoria para el índice de fechas");
+        return NULL;
+    }
+    entry->time = creation_time;
+    entry->node = node;
+    entry->level = level;
+    return entry;
+}
+
+// Enlaza una entrada en la lista. Debe llamarse con el bloqueo tomado.
+static void link_entry(TimeEntry *entry)
+{
+    int level = entry->level;
+    entry->seq = index_state.next_seq++;
+
+    TimeEntry *preds[MAX_LEVEL];
+    TimeEntry *last = index_state.tail[0];
+    if (!last || !entry_less(entry, last->time, last->seq))
+    {
+        // Caso común (fechas crecientes): los predecesores son las colas de cada nivel
+        for (int i = 0; i < MAX_LEVEL; i++)
+            preds[i] = index_state.tail[i];
+    }
+    else
+    {
+        find_preds(entry->time, entry->seq, preds);
+    }
+    if (level > index_state.level)
+    {
+        for (int i = index_state.level; i < level; i++)
+            preds[i] = NULL;
+        index_state.level = level;
+    }
+
+    for (int i = 0; i < level; i++)
+    {
+        TimeEntry **link = preds[i] ? &preds[i]->next[i] : &index_state.head[i];
+        entry->next[i] = *link;
+        *link = entry;
+        if (!entry->next[i])
+            index_state.tail[i] = entry;
+    }
+    entry->prev = preds[0];
+    if (entry->next[0])
+        entry->next[0]->prev = entry;
+
+    index_state.size++;
+    index_state.bytes += malloc_usable_size(entry);
+}
+
+TimeEntry *time_index_insert(time_t creation_time, Node *node)
+{
+    TimeEntry *entry = new_entry(creation_time, node);
+    if (!entry)
+        return NULL;
+
+    pthread_mutex_lock(&index_state.lock);
+    link_entry(entry);
+    pthread_mutex_unlock(&index_state.lock);
+    return entry;
+}
+
+void time_index_insert_batch(Node *const *nodes, size_t count, TimeEntry **entries)
+{
+    for (size_t i = 0; i < count; i++)
+        entries[i] = new_entry(get_creation_time(nodes[i]), nodes[i]);
+
+    // Los nodos de un lote suelen tener la misma fecha, así que cada entrada
+    // va al final de la lista sin buscar a sus predecesores
+    pthread_mutex_lock(&index_state.lock);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (entries[i])
+            link_entry(entries[i]);
+    }
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+// Desenlaza una entrada de la lista. Debe llamarse con el bloqueo tomado.
+static void unlink_entry(TimeEntry *entry)
+{
+    // La primera entrada lo es en todos sus niveles: no hace falta buscar sus
+    // predecesores. Es el caso común al liberar nodos en orden de creación.
+    TimeEntry *preds[MAX_LEVEL];
+    if (!entry->prev)
+    {
+        for (int i = 0; i < entry->level; i++)
+            preds[i] = NULL;
+    }
+    else
+    {
+        find_preds(entry->time, entry->seq, preds);
+    }
+    for (int i = 0; i < entry->level; i++)
+    {
+        TimeEntry **link = preds[i] ? &preds[i]->next[i] : &index_state.head[i];
+        *link = entry->next[i];
+        if (index_state.tail[i] == entry)
+            index_state.tail[i] = preds[i];
+    }
+    if (entry->next[0])
+        entry->next[0]->prev = entry->prev;
+    while (index_state.level > 1 && !index_state.head[index_state.level - 1])
+        index_state.level--;
+
+    index_state.size--;
+    index_state.bytes -= malloc_usable_size(entry);
+}
+
+void time_index_remove(TimeEntry *entry)
+{
+    time_index_remove_batch(&entry, 1);
+}
+
+void time_index_remove_batch(TimeEntry *const *entries, size_t count)
+{
+    pthread_mutex_lock(&index_state.lock);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (entries[i])
+            unlink_entry(entries[i]);
+    }
+    pthread_mutex_unlock(&index_state.lock);
+
+    for (size_t i = 0; i < count; i++)
+        free(entries[i]);
+}
+
+void time_index_clear()
+{
+    pthread_mutex_lock(&index_state.lock);
+    TimeEntry *entry = index_state.head[0];
+    while (entry)
+    {
+        TimeEntry *next = entry->next[0];
+        free(entry);
+        entry = next;
+    }
+    for (int i = 0; i < MAX_LEVEL; i++)
+    {
+        index_state.head[i] = NULL;
+        index_state.tail[i] = NULL;
+    }
+    index_state.level = 1;
+    index_state.size = 0;
+    index_state.bytes = 0;
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+void time_index_relocate(TimeEntry *entry, Node *node)
+{
+    if (!entry)
+        return;
+
+    pthread_mutex_lock(&index_state.lock);
+    entry->node = node;
+    pthread_mutex_unlock(&index_state.lock);
+}
+
+size_t time_index_range(time_t from, time_t to, TimeVisitor visit, void *ctx)
+{
+    pthread_mutex_lock(&index_state.lock);
+
+    TimeEntry *preds[MAX_LEVEL];
+    find_preds(from, 0, preds);
+    TimeEntry *entry = preds[0] ? preds[0]->next[0] : index_state.head[0];
+
+    size_t visited = 0;
+    for (; entry && entry->time <= to; entry = entry->next[0])
+    {
+        visited++;
+        if (!visit(entry->node, ctx))
+            break;
+    }
+
+    pthread_mutex_unlock(&index_state.lock);
+    return visited;
+}
+
+size_t time_index_recent(size_t count, TimeVisitor visit, void *ctx)
+{
+    pthread_mutex_lock(&index_state.lock);
+
+    size_t visited = 0;
+    for (TimeEntry *entry = index_state.tail[0]; entry && visited < count; entry = entry->prev)
+    {
+        visited++;
+        if (!visit(entry->node, ctx))
+            break;
+    }
+
+    pthread_mutex_unlock(&index_state.lock);
+    return visited;
+}
+
+size_t time_index_size()
+{
+    pthread_mutex_lock(&index_state.lock);
+    size_t size = index_state.size;
+    pthread_mutex_unlock(&index_state.lock);
+    return size;
+}
+
+size_t time_index_memory()
+{
+    pthread_mutex_lock(&index_state.lock);
+    size_t bytes = index_state.bytes;
+    pthread_mutex_unlock(&index_state.lock);
+    return bytes;
+}
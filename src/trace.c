@@ -0,0 +1,377 @@
+#include "include/trace.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Cantidad máxima de diferencias que se muestran al reproducir
+#define MAX_REPORTED_MISMATCHES 20
+
+// Registro de la traza; le siguen 'length' bytes con las palabras del
+// comando separadas por '\0' (igual que CommandRecord.text)
+typedef struct
+{
+    uint64_t time_ns;     // Desde el comienzo de la grabación
+    uint64_t latency_ns;
+    uint64_t output_hash; // FNV-1a de la salida del comando
+    uint32_t output_len;
+    uint16_t length;
+    uint8_t result;       // CommandResult
+    uint8_t reserved;
+} TraceRecord;
+
+struct TraceWriter
+{
+    FILE *file;
+    FILE *capture;     // Salida del comando en curso (open_memstream)
+    char *buffer;
+    size_t buffer_size;
+    uint64_t start_ns;
+    bool failed;
+};
+
+// Latencia de un comando reproducido
+typedef struct
+{
+    uint8_t id;
+    uint64_t ns;
+} Sample;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Hash FNV-1a de 64 bits
+static uint64_t hash_output(const char *data, size_t len)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Ejecuta el comando con la salida redirigida a 'capture' (un open_memstream).
+// Deja en '*len' los bytes escritos, que quedan al principio de su búfer, y en
+// '*latency' lo que tardó.
+static CommandResult run_captured(FileSystem *fs, const CommandRecord *record, FILE *capture,
+                                  size_t *len, uint64_t *latency)
+{
+    FILE *out = fs->out;
+    fseeko(capture, 0, SEEK_SET);
+    fs->out = capture;
+
+    uint64_t start = now_ns();
+    CommandResult result = execute_command(fs, record);
+    *latency = now_ns() - start;
+
+    fs->out = out;
+    fflush(capture);
+    off_t pos = ftello(capture);
+    *len = pos > 0 ? (size_t)pos : 0;
+    return result;
+}
+
+TraceWriter *trace_open(const char *path)
+{
+    TraceWriter *trace = calloc(1, sizeof(TraceWriter));
+    if (!trace)
+    {
+        perror("Error al asignar memoria para la traza");
+        return NULL;
+    }
+
+    trace->file = fopen(path, "wb");
+    if (!trace->file)
+    {
+        perror("Error al crear el archivo de traza");
+        free(trace);
+        return NULL;
+    }
+    trace->capture = open_memstream(&trace->buffer, &trace->buffer_size);
+    if (!trace->capture)
+    {
+        perror("Error al crear el búfer de la traza");
+        fclose(trace->file);
+        free(trace);
+        return NULL;
+    }
+
+    if (fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), trace->file) != strlen(TRACE_MAGIC))
+        trace->failed = true;
+    trace->start_ns = now_ns();
+    return trace;
+}
+
+CommandResult trace_execute(TraceWriter *trace, FileSystem *fs, const CommandRecord *record)
+{
+    TraceRecord rec = {0};
+    rec.time_ns = now_ns() - trace->start_ns;
+
+    size_t len;
+    CommandResult result = run_captured(fs, record, trace->capture, &len, &rec.latency_ns);
+
+    // La salida capturada se muestra igual que si no se grabara
+    fwrite(trace->buffer, 1, len, fs->out);
+
+    rec.output_hash = hash_output(trace->buffer, len);
+    rec.output_len = (uint32_t)len;
+    rec.length = record->length;
+    rec.result = (uint8_t)result;
+    if (fwrite(&rec, sizeof(rec), 1, trace->file) != 1 ||
+        fwrite(record->text, 1, record->length, trace->file) != record->length)
+    {
+        if (!trace->failed)
+            perror("Error al escribir la traza");
+        trace->failed = true;
+    }
+    return result;
+}
+
+bool trace_close(TraceWriter *trace)
+{
+    if (!trace)
+        return false;
+
+    bool ok = !trace->failed;
+    if (fclose(trace->file) != 0)
+    {
+        perror("Error al cerrar el archivo de traza");
+        ok = false;
+    }
+    fclose(trace->capture);
+    free(trace->buffer);
+    free(trace);
+    return ok;
+}
+
+// Lee el siguiente registro y reconstruye el comando. Devuelve false al final
+// del archivo o si el registro está dañado ('*corrupt' lo distingue).
+static bool read_record(FILE *file, TraceRecord *rec, CommandRecord *command, bool *corrupt)
+{
+    size_t got = fread(rec, 1, sizeof(*rec), file);
+    *corrupt = got != 0 && got != sizeof(*rec);
+    if (got != sizeof(*rec))
+        return false;
+
+    char text[MAX_CMD];
+    if (rec->length >= MAX_CMD || fread(text, 1, rec->length, file) != rec->length)
+    {
+        *corrupt = true;
+        return false;
+    }
+
+    // Se vuelve a tokenizar para no depender de la numeración de CommandId
+    for (size_t i = 0; i + 1 < rec->length; i++)
+    {
+        if (text[i] == '\0')
+            text[i] = ' ';
+    }
+    text[rec->length] = '\0';
+    parse_command(text, command);
+    return true;
+}
+
+static int compare_samples(const void *a, const void *b)
+{
+    const Sample *x = a, *y = b;
+    if (x->id != y->id)
+        return x->id < y->id ? -1 : 1;
+    return x->ns < y->ns ? -1 : (x->ns > y->ns);
+}
+
+static int compare_ns(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : (x > y);
+}
+
+// Percentil por rango más cercano de un arreglo ordenado
+static double percentile_us(const uint64_t *sorted, size_t count, double p)
+{
+    size_t rank = (size_t)(p / 100.0 * (double)count + 0.999999);
+    if (rank == 0)
+        rank = 1;
+    if (rank > count)
+        rank = count;
+    return (double)sorted[rank - 1] / 1e3;
+}
+
+static void print_latencies(FILE *out, const char *name, const uint64_t *sorted, size_t count)
+{
+    fprintf(out, "  %-10s %8zu %10.1f %10.1f %10.1f %10.1f\n", name, count,
+            percentile_us(sorted, count, 50), percentile_us(sorted, count, 90),
+            percentile_us(sorted, count, 99), (double)sorted[count - 1] / 1e3);
+}
+
+// Agrega una muestra, haciendo crecer el arreglo si hace falta
+static bool push_sample(Sample **samples, size_t *count, size_t *capacity, uint8_t id, uint64_t ns)
+{
+    if (*count == *capacity)
+    {
+        size_t new_capacity = *capacity ? *capacity * 2 : 1024;
+        Sample *grown = realloc(*samples, new_capacity * sizeof(Sample));
+        if (!grown)
+            return false;
+        *samples = grown;
+        *capacity = new_capacity;
+    }
+    (*samples)[(*count)++] = (Sample){id, ns};
+    return true;
+}
+
+// Muestra el rendimiento y los percentiles de latencia (en microsegundos)
+static void report(FILE *out, Sample *samples, size_t count, const char *const *names,
+                   double elapsed_s, size_t mismatches)
+{
+    fprintf(out, "Comandos: %zu en %.3f s (%.0f comandos/s)\n", count, elapsed_s,
+            elapsed_s > 0.0 ? (double)count / elapsed_s : 0.0);
+    fprintf(out, "Resultados distintos a la grabación: %zu\n", mismatches);
+    if (count == 0)
+        return;
+
+    uint64_t *sorted = malloc(count * sizeof(uint64_t));
+    if (!sorted)
+    {
+        perror("Error al asignar memoria para las latencias");
+        return;
+    }
+
+    fprintf(out, "Latencia (µs):\n");
+    fprintf(out, "  %-10s %8s %10s %10s %10s %10s\n", "comando", "n", "p50", "p90", "p99", "max");
+    for (size_t i = 0; i < count; i++)
+        sorted[i] = samples[i].ns;
+    qsort(sorted, count, sizeof(uint64_t), compare_ns);
+    print_latencies(out, "total", sorted, count);
+
+    // Por comando: las muestras quedan agrupadas por id y ordenadas por latencia
+    qsort(samples, count, sizeof(Sample), compare_samples);
+    size_t begin = 0;
+    while (begin < count)
+    {
+        size_t end = begin;
+        while (end < count && samples[end].id == samples[begin].id)
+        {
+            sorted[end - begin] = samples[end].ns;
+            end++;
+        }
+        const char *name = names[samples[begin].id] ? names[samples[begin].id] : "?";
+        print_latencies(out, name, sorted, end - begin);
+        begin = end;
+    }
+    free(sorted);
+}
+
+bool replay_trace(FileSystem *fs, const char *path, bool paced)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        perror("Error al abrir el archivo de traza");
+        return false;
+    }
+
+    char magic[sizeof(TRACE_MAGIC) - 1];
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0)
+    {
+        fprintf(stderr, "Error: '%s' no es un archivo de traza.\n", path);
+        fclose(file);
+        return false;
+    }
+
+    char *buffer = NULL;
+    size_t buffer_size = 0;
+    FILE *capture = open_memstream(&buffer, &buffer_size);
+    if (!capture)
+    {
+        perror("Error al crear el búfer de la traza");
+        fclose(file);
+        return false;
+    }
+
+    // Nombre de cada id, tomado de la primera palabra del primer comando con ese id
+    char names_buf[CMD_UNKNOWN + 1][32] = {{0}};
+    const char *names[CMD_UNKNOWN + 1] = {NULL};
+
+    Sample *samples = NULL;
+    size_t count = 0, capacity = 0, mismatches = 0;
+    bool corrupt = false, ok = true;
+    TraceRecord rec;
+    CommandRecord command;
+    uint64_t start = now_ns();
+
+    while (read_record(file, &rec, &command, &corrupt))
+    {
+        if (paced)
+        {
+            // Espera hasta el mismo instante relativo en que llegó al grabar.
+            // Solo se reintenta si una señal interrumpió la espera: con un
+            // tiempo inválido (traza dañada) se sigue sin esperar.
+            uint64_t due = start + rec.time_ns;
+            struct timespec ts = {(time_t)(due / 1000000000ULL), (long)(due % 1000000000ULL)};
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+                ;
+        }
+
+        size_t len;
+        uint64_t latency;
+        CommandResult result = run_captured(fs, &command, capture, &len, &latency);
+        uint64_t hash = hash_output(buffer, len);
+
+        if (command.id <= CMD_UNKNOWN && !names[command.id])
+        {
+            snprintf(names_buf[command.id], sizeof(names_buf[command.id]), "%.31s",
+                     command.id == CMD_EMPTY ? "(vacío)" : command.id == CMD_UNKNOWN ? "(otro)" : command.text);
+            names[command.id] = names_buf[command.id];
+        }
+        if (!push_sample(&samples, &count, &capacity, command.id, latency))
+        {
+            perror("Error al asignar memoria para las latencias");
+            ok = false;
+            break;
+        }
+
+        if ((uint8_t)result != rec.result || len != rec.output_len || hash != rec.output_hash)
+        {
+            if (mismatches < MAX_REPORTED_MISMATCHES)
+            {
+                // Se muestra el comando con espacios en lugar de '\0'
+                char line[MAX_CMD];
+                memcpy(line, command.text, command.length);
+                for (size_t i = 0; i + 1 < command.length; i++)
+                    if (line[i] == '\0')
+                        line[i] = ' ';
+                line[command.length ? command.length - 1 : 0] = '\0';
+                fprintf(fs->out, "Diferencia en el comando %zu (%s): resultado %d/%d, salida %zu/%u bytes%s\n",
+                        count, line, (int)result, (int)rec.result, len, rec.output_len,
+                        len == rec.output_len && hash != rec.output_hash ? " con otro contenido" : "");
+            }
+            mismatches++;
+        }
+
+        if (result == RESULT_EXIT)
+            break;
+    }
+    double elapsed_s = (double)(now_ns() - start) / 1e9;
+
+    if (corrupt)
+    {
+        fprintf(stderr, "Error: la traza '%s' está dañada después del comando %zu.\n", path, count);
+        ok = false;
+    }
+
+    report(fs->out, samples, count, names, elapsed_s, mismatches);
+
+    free(samples);
+    fclose(capture);
+    free(buffer);
+    fclose(file);
+    return ok && mismatches == 0;
+}
@@ -0,0 +1,201 @@
+#include "../src/include/commands.h"
+#include "../src/include/dispatch.h"
+#include "../src/include/trace.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Sistema de archivos de prueba con los mensajes de error en un búfer
+static FileSystem *create_test_filesystem(FILE **err, char **err_text, size_t *err_size)
+{
+    FileSystem *fs = init_filesystem();
+    assert(fs != NULL);
+    *err = open_memstream(err_text, err_size);
+    assert(*err != NULL);
+    fs->err = *err;
+    return fs;
+}
+
+// Prueba para rm con un solo nombre: solo busca en el directorio actual
+void test_rm_current_dir() {
+    FILE *err;
+    char *err_text = NULL;
+    size_t err_size = 0;
+    FileSystem *fs = create_test_filesystem(&err, &err_text, &err_size);
+
+    assert(touch(fs, "a"));
+    assert(mkdir(fs, "d"));
+    assert(cd(fs, "d"));
+    assert(touch(fs, "b"));
+    assert(cd(fs, ".."));
+
+    // "b" está en un subdirectorio: no se borra
+    assert(!rm(fs, "b"));
+    fflush(err);
+    assert(strstr(err_text, "El archivo no existe") != NULL);
+    Node *d = find_child(fs->root, "d", DIR_TYPE);
+    assert(d != NULL && find_child(d, "b", FILE_TYPE) != NULL);
+
+    // Un directorio con el nombre tampoco
+    assert(!rm(fs, "d"));
+    assert(find_child(fs->root, "d", DIR_TYPE) != NULL);
+
+    assert(rm(fs, "a"));
+    assert(find_child(fs->root, "a", FILE_TYPE) == NULL);
+
+    exit_filesystem(fs);
+    fclose(err);
+    free(err_text);
+    printf("test_rm_current_dir: OK\n");
+}
+
+// Sistema de archivos nuevo que escribe los errores en 'err'
+static FileSystem *reuse_error_stream(FileSystem *fs, FILE *err)
+{
+    assert(fs != NULL);
+    fs->err = err;
+    return fs;
+}
+
+// Archivo temporal de las pruebas de trazas
+#define TRACE_PATH "/tmp/simfs_test_trace"
+
+// Reemplaza el archivo de traza por sus primeros 'size' bytes seguidos de 'extra'
+static void rewrite_trace(const char *data, size_t size, const char *extra, size_t extra_size)
+{
+    FILE *file = fopen(TRACE_PATH, "wb");
+    assert(file != NULL);
+    assert(fwrite(data, 1, size, file) == size);
+    assert(fwrite(extra, 1, extra_size, file) == extra_size);
+    fclose(file);
+}
+
+// Reproduce la traza sobre 'fs' y deja en 'report' lo que escribió
+static bool replay_to_buffer(FileSystem *fs, bool paced, char **report, size_t *report_size)
+{
+    FILE *out = open_memstream(report, report_size);
+    assert(out != NULL);
+    fs->out = out;
+    bool ok = replay_trace(fs, TRACE_PATH, paced);
+    fs->out = stdout;
+    fclose(out);
+    return ok;
+}
+
+// Prueba para la grabación y reproducción de trazas
+void test_trace() {
+    FILE *err;
+    char *err_text = NULL;
+    size_t err_size = 0;
+    FileSystem *fs = create_test_filesystem(&err, &err_text, &err_size);
+
+    // Se graban unos comandos con su salida en un búfer
+    const char *lines[] = {"mkdir d", "touch a", "cd d", "touch b", "pwd", "cd ..", "ls", "rm a"};
+    size_t line_count = sizeof(lines) / sizeof(lines[0]);
+    char *out_text = NULL;
+    size_t out_size = 0;
+    FILE *out = open_memstream(&out_text, &out_size);
+    assert(out != NULL);
+    fs->out = out;
+    TraceWriter *trace = trace_open(TRACE_PATH);
+    assert(trace != NULL);
+    for (size_t i = 0; i < line_count; i++)
+    {
+        CommandRecord record;
+        parse_command(lines[i], &record);
+        assert(trace_execute(trace, fs, &record) == RESULT_OK);
+    }
+    assert(trace_close(trace));
+    fs->out = stdout;
+    fclose(out);
+    // La salida se muestra igual que sin grabar
+    assert(strstr(out_text, "/d") != NULL);
+    free(out_text);
+    exit_filesystem(fs);
+
+    // Sobre un sistema vacío se obtienen los mismos resultados
+    char *report = NULL;
+    size_t report_size = 0;
+    fs = reuse_error_stream(init_filesystem(), err);
+    assert(replay_to_buffer(fs, false, &report, &report_size));
+    assert(strstr(report, "Comandos: 8 ") != NULL);
+    assert(strstr(report, "Resultados distintos a la grabación: 0") != NULL);
+    free(report);
+    exit_filesystem(fs);
+
+    // Respetando los tiempos grabados también
+    report = NULL;
+    fs = reuse_error_stream(init_filesystem(), err);
+    assert(replay_to_buffer(fs, true, &report, &report_size));
+    free(report);
+    exit_filesystem(fs);
+
+    // Si "a" ya existe, touch falla y ls muestra otra salida
+    report = NULL;
+    fs = reuse_error_stream(init_filesystem(), err);
+    assert(touch(fs, "a"));
+    assert(!replay_to_buffer(fs, false, &report, &report_size));
+    assert(strstr(report, "Diferencia en el comando 2 (touch a)") != NULL);
+    assert(strstr(report, "Diferencia en el comando 7 (ls)") != NULL);
+    assert(strstr(report, "Resultados distintos a la grabación: 2") != NULL);
+    free(report);
+    exit_filesystem(fs);
+
+    // Se lee la traza completa para armar versiones dañadas
+    FILE *file = fopen(TRACE_PATH, "rb");
+    assert(file != NULL);
+    char data[4096];
+    size_t size = fread(data, 1, sizeof(data), file);
+    fclose(file);
+    assert(size > strlen(TRACE_MAGIC) && size < sizeof(data));
+
+    // Traza cortada en medio del último comando: se reproduce lo anterior
+    // y se informa el daño
+    rewrite_trace(data, size - 3, "", 0);
+    report = NULL;
+    fs = reuse_error_stream(init_filesystem(), err);
+    assert(!replay_to_buffer(fs, false, &report, &report_size));
+    assert(strstr(report, "Comandos: 7 ") != NULL);
+    assert(strstr(report, "Resultados distintos a la grabación: 0") != NULL);
+    free(report);
+    exit_filesystem(fs);
+
+    // Bytes sueltos después del último registro
+    rewrite_trace(data, size, "xyz", 3);
+    report = NULL;
+    fs = reuse_error_stream(init_filesystem(), err);
+    assert(!replay_to_buffer(fs, false, &report, &report_size));
+    assert(strstr(report, "Comandos: 8 ") != NULL);
+    free(report);
+    exit_filesystem(fs);
+
+    // Archivo que no empieza con la marca de traza
+    rewrite_trace("SIMFSTR0", 8, data + 8, size - 8);
+    report = NULL;
+    fs = reuse_error_stream(init_filesystem(), err);
+    assert(!replay_to_buffer(fs, false, &report, &report_size));
+    free(report);
+    exit_filesystem(fs);
+
+    // Archivo vacío
+    rewrite_trace("", 0, "", 0);
+    fs = reuse_error_stream(init_filesystem(), err);
+    assert(!replay_trace(fs, TRACE_PATH, false));
+    exit_filesystem(fs);
+
+    remove(TRACE_PATH);
+    fclose(err);
+    free(err_text);
+    printf("test_trace: OK\n");
+}
+
+int main() {
+    test_rm_current_dir();
+    test_trace();
+
+    printf("Todas las pruebas pasaron.\n");
+    return 0;
+}
+
+//Puedes probarlo con este comando (desde src/): gcc -Wall -Wextra -g -pthread $(ls *.c | grep -v main.c) ../test/test_commands.c -o test_commands
@@ -1,7 +1,12 @@
+#include "../src/include/bgsave.h"
 #include "../src/include/node.h"
+#include "../src/include/time_index.h"
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 // Prueba para create_node
 void test_create_node() {
@@ -28,6 +33,22 @@ void test_add_child() {
     printf("test_add_child: OK\n");
 }
 
+// Prueba para add_child_after
+void test_add_child_after() {
+    Node *parent = create_node("parent", DIR_TYPE, NULL);
+    Node *first = create_node("first", FILE_TYPE, NULL);
+    Node *second = create_node("second", FILE_TYPE, NULL);
+
+    add_child_after(parent, NULL, first);
+    add_child_after(parent, first, second);
+    assert(get_first_child(parent) == first);
+    assert(get_next_sibling(first) == second);
+    assert(get_parent(second) == parent);
+
+    free_tree(parent);
+    printf("test_add_child_after: OK\n");
+}
+
 // Prueba para remove_node
 void test_remove_node() {
     Node *parent = create_node("parent", DIR_TYPE, NULL);
@@ -41,6 +62,505 @@ void test_remove_node() {
     printf("test_remove_node: OK\n");
 }
 
+// Prueba para add_children y remove_children_if
+static bool ends_with_tmp(const char *name, void *ctx) {
+    (void)ctx;
+    size_t len = strlen(name);
+    return len >= 4 && strcmp(name + len - 4, ".tmp") == 0;
+}
+
+void test_batch() {
+    Node *parent = create_node("parent", DIR_TYPE, NULL);
+    Node *existing = create_node("a.tmp", FILE_TYPE, NULL);
+    add_child(parent, existing);
+
+    const char *names[] = {"a.tmp", "b.tmp", "c.txt", "b.tmp"};
+    assert(add_children(parent, names, 4, FILE_TYPE) == 2);  // a.tmp ya existe, b.tmp repetido
+    assert(get_first_child(parent) == existing);
+    assert(strcmp(get_node_name(get_next_sibling(existing)), "b.tmp") == 0);
+
+    assert(remove_children_if(parent, FILE_TYPE, ends_with_tmp, NULL) == 2);
+    assert(strcmp(get_node_name(get_first_child(parent)), "c.txt") == 0);
+    assert(get_next_sibling(get_first_child(parent)) == NULL);
+
+    // Más nombres que un lote: todos quedan en los índices y en orden
+    size_t before = time_index_size();
+    enum { MANY = 1000 };
+    static char many_buf[MANY][16];
+    const char *many[MANY];
+    for (int i = 0; i < MANY; i++) {
+        snprintf(many_buf[i], sizeof(many_buf[i]), "f%d.log", i);
+        many[i] = many_buf[i];
+    }
+    assert(add_children(parent, many, MANY, FILE_TYPE) == MANY);
+    assert(time_index_size() == before + MANY);
+    assert(has_child_named(parent, "f0.log", FILE_TYPE));
+    assert(has_child_named(parent, "f999.log", FILE_TYPE));
+    assert(!has_child_named(parent, "f999.log", DIR_TYPE));
+    assert(strcmp(get_node_name(get_next_sibling(get_first_child(parent))), "f0.log") == 0);
+
+    // Al quitar la mitad, el resto se sigue encontrando
+    Node *child = get_next_sibling(get_first_child(parent));
+    for (int i = 0; i < MANY; i += 2) {
+        Node *next = get_next_sibling(get_next_sibling(child));
+        remove_node(child);
+        child = next;
+    }
+    assert(time_index_size() == before + MANY / 2);
+    assert(!has_child_named(parent, "f0.log", FILE_TYPE));
+    assert(has_child_named(parent, "f1.log", FILE_TYPE));
+    assert(has_child_named(parent, "f999.log", FILE_TYPE));
+
+    free_tree(parent);
+    assert(time_index_size() == before - 2);
+    printf("test_batch: OK\n");
+}
+
+// Prueba para el índice por fecha de creación
+static bool collect_node(Node *node, void *ctx) {
+    Node **out = ctx;
+    while (*out) out++;
+    *out = node;
+    return true;
+}
+
+void test_time_index() {
+    size_t before = time_index_size();
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    Node *old = create_node("old", FILE_TYPE, root);
+    Node *mid = create_node("mid", FILE_TYPE, root);
+    add_child(root, old);
+    add_child(root, mid);
+    set_creation_time(root, 300);
+    set_creation_time(old, 100);
+    set_creation_time(mid, 200);
+    assert(time_index_size() == before + 3);
+
+    Node *found[4] = {NULL};
+    assert(time_index_range(150, 250, collect_node, found) == 1);
+    assert(found[0] == mid);
+
+    remove_node(mid);
+    memset(found, 0, sizeof(found));
+    assert(time_index_range(0, 1000, collect_node, found) == 2);
+    assert(found[0] == old && found[1] == root);
+
+    free_tree(root);
+    assert(time_index_size() == before);
+    printf("test_time_index: OK\n");
+}
+
+// Prueba para has_child_named (índice de nombres)
+void test_has_child_named() {
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    Node *dir = create_node("dir", DIR_TYPE, root);
+    Node *file = create_node("config.json", FILE_TYPE, dir);
+    add_child(root, dir);
+    add_child(dir, file);
+
+    assert(has_child_named(dir, "config.json", FILE_TYPE));
+    assert(!has_child_named(dir, "config.json", DIR_TYPE));
+    assert(!has_child_named(root, "config.json", FILE_TYPE));
+    assert(find_child(dir, "config.json", FILE_TYPE) == file);
+    assert(find_child(root, "config.json", FILE_TYPE) == NULL);
+
+    remove_node(file);
+    assert(!has_child_named(dir, "config.json", FILE_TYPE));
+
+    // Un nodo creado sin padre queda indexado bajo el padre de add_child
+    Node *orphan = create_node("orphan", FILE_TYPE, NULL);
+    add_child(dir, orphan);
+    assert(has_child_named(dir, "orphan", FILE_TYPE));
+    assert(!has_child_named(root, "orphan", FILE_TYPE));
+
+    // Muchos hermanos con el mismo nombre en otros directorios
+    for (int i = 0; i < 2000; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "d%d", i);
+        Node *other = create_node(name, DIR_TYPE, root);
+        add_child(root, other);
+        add_child(other, create_node("same", FILE_TYPE, other));
+    }
+    assert(!has_child_named(dir, "same", FILE_TYPE));
+    Node *d1999 = find_immediate_child(root, "d1999");
+    assert(has_child_named(d1999, "same", FILE_TYPE));
+
+    free_tree(root);
+    printf("test_has_child_named: OK\n");
+}
+
+// Prueba para compact_tree
+void test_compact_tree() {
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    Node *dir = create_node("dir", DIR_TYPE, root);
+    Node *file = create_node("file", FILE_TYPE, root);
+    Node *inner = create_node("inner", FILE_TYPE, dir);
+    add_child(root, dir);
+    add_child(root, file);
+    add_child(dir, inner);
+    set_creation_time(inner, 42);
+
+    Node *current = dir;
+    root = compact_tree(root, &current);
+    assert(strcmp(get_node_name(current), "dir") == 0);
+    assert(get_parent(current) == root);
+    assert(get_first_child(root) == current);
+    assert(strcmp(get_node_name(get_next_sibling(current)), "file") == 0);
+
+    Node *moved = find_node(root, "inner", FILE_TYPE);
+    assert(moved && get_parent(moved) == current);
+    assert(has_child_named(current, "inner", FILE_TYPE));
+    Node *found[2] = {NULL};
+    assert(time_index_range(42, 42, collect_node, found) == 1);
+    assert(found[0] == moved);
+
+    free_tree(root);
+    printf("test_compact_tree: OK\n");
+}
+
+// Escribe el árbol con write_preorder en un búfer nuevo (hay que liberarlo)
+static char *preorder_text(const Node *root) {
+    char *text = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&text, &size);
+    assert(out != NULL);
+    write_preorder(out, root, "");
+    fclose(out);
+    return text;
+}
+
+// Prueba de ida y vuelta del formato compacto (wrts --compact)
+void test_compact_roundtrip() {
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    set_creation_time(root, 1000);
+    // "/a" y "/ab" comparten prefijo pero son hermanos
+    Node *a = create_node("a", DIR_TYPE, root);
+    Node *ab = create_node("ab", DIR_TYPE, root);
+    Node *b = create_node("b", FILE_TYPE, root);
+    add_child(root, a);
+    add_child(root, ab);
+    add_child(root, b);
+    Node *ax = create_node("x", FILE_TYPE, a);
+    Node *ay = create_node("y", DIR_TYPE, a);
+    Node *abx = create_node("x", FILE_TYPE, ab);
+    Node *deep = create_node("deep", FILE_TYPE, ay);
+    add_child(a, ax);
+    add_child(a, ay);
+    add_child(ab, abx);
+    add_child(ay, deep);
+    // Diferencias de fecha positivas, negativas y nulas
+    set_creation_time(a, 5000);
+    set_creation_time(ax, 4000);
+    set_creation_time(ay, 4000);
+    set_creation_time(deep, 90000);
+    set_creation_time(ab, 10);
+    set_creation_time(abx, 20);
+    set_creation_time(b, 3000);
+
+    FILE *file = tmpfile();
+    assert(file != NULL);
+    write_preorder_compact(file, root);
+    rewind(file);
+
+    Node *loaded = create_node("root", DIR_TYPE, NULL);
+    assert(read_preorder_compact(file, loaded));
+    fclose(file);
+
+    char *expected = preorder_text(root);
+    char *actual = preorder_text(loaded);
+    assert(strcmp(expected, actual) == 0);
+    assert(get_creation_time(loaded) == 1000);
+    Node *loaded_ab = get_next_sibling(get_first_child(loaded));
+    assert(strcmp(get_node_name(loaded_ab), "ab") == 0);
+    assert(get_creation_time(loaded_ab) == 10);
+    assert(get_creation_time(get_first_child(loaded_ab)) == 20);
+
+    // Un archivo sin el encabezado no se carga
+    file = tmpfile();
+    assert(file != NULL);
+    write_preorder(file, root, "");
+    rewind(file);
+    Node *other = create_node("root", DIR_TYPE, NULL);
+    assert(!read_preorder_compact(file, other));
+    assert(get_first_child(other) == NULL);
+    fclose(file);
+
+    free(expected);
+    free(actual);
+    free_tree(other);
+    free_tree(loaded);
+    free_tree(root);
+    printf("test_compact_roundtrip: OK\n");
+}
+
+// Archivo de las pruebas de bgsave
+#define BGSAVE_PATH "/tmp/simfs_test_bgsave"
+
+// Prueba del guardado en segundo plano (bgsave)
+void test_bgsave() {
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    Node *d = create_node("d", DIR_TYPE, root);
+    Node *f = create_node("f", FILE_TYPE, root);
+    Node *g = create_node("g", FILE_TYPE, d);
+    add_child(root, d);
+    add_child(root, f);
+    add_child(d, g);
+    set_creation_time(d, 2000);
+    set_creation_time(f, 1000);
+    set_creation_time(g, 3000);
+    char *expected = preorder_text(root);
+    char tmp_file[64];
+
+    // Formato compacto: el temporal se renombra y el árbol se recarga igual
+    remove(BGSAVE_PATH);
+    double pause_ms = -1;
+    pid_t pid = save_in_background(root, BGSAVE_PATH, true, &pause_ms);
+    assert(pid > 0);
+    assert(pause_ms >= 0);
+    assert(poll_background_save(pid, true) == SAVE_OK);
+    snprintf(tmp_file, sizeof(tmp_file), "%s.tmp.%d", BGSAVE_PATH, (int)pid);
+    assert(access(tmp_file, F_OK) != 0);
+    FILE *file = fopen(BGSAVE_PATH, "r");
+    assert(file != NULL);
+    Node *loaded = create_node("root", DIR_TYPE, NULL);
+    assert(read_preorder_compact(file, loaded));
+    fclose(file);
+    char *actual = preorder_text(loaded);
+    assert(strcmp(expected, actual) == 0);
+    assert(get_creation_time(find_child(loaded, "d", DIR_TYPE)) == 2000);
+    free(actual);
+    free_tree(loaded);
+
+    // Formato de texto: el archivo es lo mismo que escribe write_preorder
+    pid = save_in_background(root, BGSAVE_PATH, false, NULL);
+    assert(pid > 0);
+    assert(poll_background_save(pid, true) == SAVE_OK);
+    snprintf(tmp_file, sizeof(tmp_file), "%s.tmp.%d", BGSAVE_PATH, (int)pid);
+    assert(access(tmp_file, F_OK) != 0);
+    file = fopen(BGSAVE_PATH, "r");
+    assert(file != NULL);
+    char text[256];
+    size_t size = fread(text, 1, sizeof(text) - 1, file);
+    text[size] = '\0';
+    fclose(file);
+    assert(strcmp(expected, text) == 0);
+
+    // Un destino imposible se informa como fallido
+    pid = save_in_background(root, "/tmp/simfs_no_existe/archivo", true, NULL);
+    assert(pid > 0);
+    assert(poll_background_save(pid, true) == SAVE_FAILED);
+
+    remove(BGSAVE_PATH);
+    free(expected);
+    free_tree(root);
+    printf("test_bgsave: OK\n");
+}
+
+// Prueba del desalojo de subárboles fríos (--mem-limit)
+void test_spill() {
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    Node *cold = create_node("cold", DIR_TYPE, root);
+    Node *hot = create_node("hot", DIR_TYPE, root);
+    add_child(root, cold);
+    add_child(root, hot);
+    const char *names[] = {"a", "b", "c"};
+    add_children(cold, names, 3, FILE_TYPE);
+    Node *sub = create_node("sub", DIR_TYPE, cold);
+    add_child(cold, sub);
+    Node *leaf = create_node("leaf", FILE_TYPE, sub);
+    add_child(sub, leaf);
+    set_creation_time(leaf, 42);
+    add_children(hot, names, 3, FILE_TYPE);
+    mark_accessed(hot);
+
+    // Un límite mínimo desaloja todo salvo la raíz y el camino al directorio actual
+    set_memory_limit(1);
+    assert(enforce_memory_limit(root, hot) == 5);
+    MemoryStats stats;
+    get_memory_stats(&stats);
+    assert(stats.spilled_dirs == 1 && stats.spilled_nodes == 5);
+    assert(!has_child_named(hot, "leaf", FILE_TYPE));
+    assert(strcmp(get_node_name(get_first_child(hot)), "a") == 0);
+
+    // Una búsqueda fallida no recarga nada: el filtro del stub descarta el nombre
+    size_t faults = stats.faults;
+    assert(find_node(root, "missing", FILE_TYPE) == NULL);
+    get_memory_stats(&stats);
+    assert(stats.faults == faults && stats.spilled_dirs == 1);
+
+    // Al acceder a los hijos se cargan de nuevo con sus fechas
+    Node *loaded = find_node(cold, "leaf", FILE_TYPE);
+    assert(loaded && get_creation_time(loaded) == 42);
+    assert(strcmp(get_node_name(get_parent(loaded)), "sub") == 0);
+    assert(traverse_tree(root) == 11);
+
+    // Con un stub anidado (sub dentro de cold), el filtro de cold también
+    // cubre los nombres de sub
+    enforce_memory_limit(root, cold);
+    enforce_memory_limit(root, hot);
+    get_memory_stats(&stats);
+    assert(stats.spilled_dirs == 2 && stats.spilled_nodes == 8); // cold y hot
+    faults = stats.faults;
+    assert(find_node(root, "missing", FILE_TYPE) == NULL);
+    get_memory_stats(&stats);
+    assert(stats.faults == faults);
+    loaded = find_node(root, "leaf", FILE_TYPE);
+    assert(loaded && get_creation_time(loaded) == 42);
+    get_memory_stats(&stats);
+    assert(stats.faults == faults + 2);
+
+    // Las consultas de los índices globales solo recargan los subárboles que
+    // pueden tener resultados: por nombre (filtro) o por fecha (rango)
+    enforce_memory_limit(root, cold);
+    enforce_memory_limit(root, hot);
+    get_memory_stats(&stats);
+    assert(stats.spilled_dirs == 2);
+    faults = stats.faults;
+    assert(load_spilled_named("missing") == 0);
+    assert(load_spilled_in_range(10, 20) == 0);
+    get_memory_stats(&stats);
+    assert(stats.faults == faults && stats.spilled_dirs == 2);
+    // Solo cold tiene a leaf, dentro del stub anidado de sub
+    assert(load_spilled_in_range(42, 42) == 2);
+    get_memory_stats(&stats);
+    assert(stats.spilled_dirs == 1 && get_first_child(cold) != NULL);
+    assert(load_spilled_named("b") == 1);
+    get_memory_stats(&stats);
+    assert(stats.spilled_dirs == 0);
+
+    // Liberar un subárbol desalojado también libera su stub
+    enforce_memory_limit(root, hot);
+    set_memory_limit(0);
+    free_tree(root);
+    get_memory_stats(&stats);
+    assert(stats.spilled_dirs == 0 && stats.node_bytes == 0);
+    printf("test_spill: OK\n");
+}
+
+// Un hijo de bgsave que recarga un directorio no debe truncar el archivo de
+// desalojo que sigue usando el proceso principal
+void test_spill_fork() {
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    Node *cold = create_node("cold", DIR_TYPE, root);
+    Node *hot = create_node("hot", DIR_TYPE, root);
+    add_child(root, cold);
+    add_child(root, hot);
+    const char *names[] = {"a", "b", "c"};
+    add_children(cold, names, 3, FILE_TYPE);
+    mark_accessed(hot);
+
+    set_memory_limit(1);
+    assert(enforce_memory_limit(root, hot) == 3);
+
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        // Recarga el único bloque: sin stubs, el proceso dueño truncaría el archivo
+        _exit(get_first_child(cold) != NULL ? 0 : 1);
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    assert(get_first_child(cold) && strcmp(get_node_name(get_first_child(cold)), "a") == 0);
+    assert(traverse_tree(root) == 6);
+
+    // Mientras el hijo vive, el padre no trunca el archivo al recargar el
+    // último bloque, así el siguiente desalojo no escribe encima
+    assert(enforce_memory_limit(root, hot) == 3);
+    int sync[2];
+    assert(pipe(sync) == 0);
+    spill_file_pin();
+    pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        char c;
+        close(sync[1]);
+        if (read(sync[0], &c, 1) < 0)
+            _exit(1);
+        Node *first = get_first_child(cold);
+        _exit(first && strcmp(get_node_name(first), "a") == 0 ? 0 : 1);
+    }
+    close(sync[0]);
+    assert(get_first_child(cold) != NULL);
+    const char *others[] = {"x", "y", "z"};
+    add_children(hot, others, 3, FILE_TYPE);
+    assert(enforce_memory_limit(root, cold) == 3);
+    close(sync[1]);
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    spill_file_unpin();
+    assert(get_first_child(hot) && strcmp(get_node_name(get_first_child(hot)), "x") == 0);
+    assert(traverse_tree(root) == 9);
+
+    // Si el hijo no puede leer el archivo de desalojo, la copia falla en vez
+    // de quedar sin ese directorio
+    assert(enforce_memory_limit(root, hot) == 3);
+    pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        for (int fd = 3; fd < 256; fd++)
+            close(fd);
+        char *data = NULL;
+        size_t size = 0;
+        FILE *out = open_memstream(&data, &size);
+        _exit(out && !write_preorder(out, root, "") && !write_preorder_compact(out, root) ? 0 : 1);
+    }
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(traverse_tree(root) == 9);
+
+    set_memory_limit(0);
+    free_tree(root);
+    printf("test_spill_fork: OK\n");
+}
+
+static bool collect_name(Node *node, void *ctx)
+{
+    char *buffer = ctx;
+    strcat(buffer, get_node_name(node));
+    strcat(buffer, get_node_type(node) == DIR_TYPE ? "/ " : " ");
+    return true;
+}
+
+// Prueba de las consultas por prefijo (directorio chico y con árbol radix)
+void test_prefix() {
+    Node *root = create_node("root", DIR_TYPE, NULL);
+    const char *names[] = {"log-b", "log-a", "logs", "x", "log"};
+    add_children(root, names, 5, FILE_TYPE);
+    Node *dir = create_node("log-a", DIR_TYPE, root);
+    add_child(root, dir);
+
+    char found[4096] = "";
+    assert(find_children_with_prefix(root, "log-", collect_name, found) == 3);
+    assert(strcmp(found, "log-a log-a/ log-b ") == 0);
+
+    // Con muchos hijos se crea el árbol radix; el resultado debe ser el mismo
+    char name[32];
+    for (int i = 0; i < 100; i++)
+    {
+        snprintf(name, sizeof(name), "z%d", i);
+        add_child(root, create_node(name, FILE_TYPE, root));
+    }
+    found[0] = '\0';
+    assert(find_children_with_prefix(root, "log-", collect_name, found) == 3);
+    assert(strcmp(found, "log-a log-a/ log-b ") == 0);
+    assert(find_children_with_prefix(root, "z9", collect_name, found) == 11);
+
+    // El árbol se mantiene al quitar hijos y al compactar
+    remove_node(find_immediate_child(root, "log-b"));
+    remove_node(dir);
+    root = compact_tree(root, NULL);
+    found[0] = '\0';
+    assert(find_children_with_prefix(root, "lo", collect_name, found) == 3);
+    assert(strcmp(found, "log log-a logs ") == 0);
+    found[0] = '\0';
+    add_child(root, create_node("log-", FILE_TYPE, root));
+    assert(find_children_with_prefix(root, "log-", collect_name, found) == 2);
+    assert(strcmp(found, "log- log-a ") == 0);
+    assert(find_children_with_prefix(root, "q", collect_name, found) == 0);
+
+    free_tree(root);
+    printf("test_prefix: OK\n");
+}
+
 // Prueba para test_find_node 
 void test_find_node() {
     // Crear un árbol de prueba
@@ -64,14 +584,51 @@ void test_find_node() {
     printf("test_find_node: OK\n");
 }
 
+// Prueba para free_filesystem_tree: con todos los nodos en el árbol, los
+// índices quedan vacíos y se pueden seguir usando
+void test_free_filesystem_tree() {
+    Node *root = create_node("", DIR_TYPE, NULL);
+    Node *dir = create_node("dir", DIR_TYPE, root);
+    add_child(root, dir);
+    const char *names[] = {"a", "b", "c"};
+    assert(add_children(dir, names, 3, FILE_TYPE) == 3);
+    assert(time_index_size() == 5);
+
+    free_filesystem_tree(root);
+    assert(time_index_size() == 0);
+
+    root = create_node("", DIR_TYPE, NULL);
+    add_child(root, create_node("a", FILE_TYPE, root));
+    assert(has_child_named(root, "a", FILE_TYPE));
+    assert(time_index_size() == 2);
+
+    // Con otro árbol vivo se quitan solo sus nodos
+    Node *other = create_node("other", DIR_TYPE, NULL);
+    free_filesystem_tree(root);
+    assert(time_index_size() == 1);
+    free_tree(other);
+    printf("test_free_filesystem_tree: OK\n");
+}
+
 int main() {
     test_create_node();
     test_add_child();
+    test_add_child_after();
     test_remove_node();
     test_find_node();
+    test_batch();
+    test_time_index();
+    test_has_child_named();
+    test_compact_tree();
+    test_compact_roundtrip();
+    test_bgsave();
+    test_spill();
+    test_spill_fork();
+    test_prefix();
+    test_free_filesystem_tree();
 
     printf("Todas las pruebas pasaron.\n");
     return 0;
 }
 
-//Puedes probarlo con este comando: gcc -Wall -Wextra -g node.c ../test/test_node.c -o test_node
\ No newline at end of file
+//Puedes probarlo con este comando: gcc -Wall -Wextra -g -pthread node.c name_set.c time_index.c name_index.c radix.c error.c bgsave.c ../test/test_node.c -o test_node
\ No newline at end of file